@@ -0,0 +1,12 @@
+#pragma once
+
+#include <cstdint>
+
+// Counts every global operator new in the benchmark binary, so a benchmark can check that
+// a warmed-up code path allocates nothing. The replacement lives in its own translation
+// unit to keep it out of line; other benchmarks pay one relaxed increment per allocation.
+namespace BenchAllocations {
+
+uint64_t count();
+
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <numbers>
+#include <span>
+#include <vector>
+
+// Deterministic test signals shared by the benchmarks. Everything is seeded so two runs
+// (or two machines) feed the code under test exactly the same samples.
+namespace BenchSignals {
+
+constexpr float SAMPLE_RATE = 44100.0f;
+
+inline std::vector<float> sine(const size_t samples, const float frequency,
+							   const float amplitude = 0.5f, const float sampleRate = SAMPLE_RATE) {
+	std::vector<float> out(samples);
+	for (size_t i = 0; i < samples; ++i) {
+		out[i] = amplitude * std::sin(2.0f * std::numbers::pi_v<float> * frequency *
+									  static_cast<float>(i) / sampleRate);
+	}
+	return out;
+}
+
+// Sum of equal-amplitude sines, normalised so the peak stays inside [-1, 1]
+inline std::vector<float> chord(const size_t samples, const std::span<const float> frequencies,
+								const float sampleRate = SAMPLE_RATE) {
+	std::vector<float> out(samples, 0.0f);
+	const float amplitude = 0.8f / static_cast<float>(frequencies.empty() ? 1 : frequencies.size());
+	for (const float frequency : frequencies) {
+		const auto tone = sine(samples, frequency, amplitude, sampleRate);
+		for (size_t i = 0; i < samples; ++i) {
+			out[i] += tone[i];
+		}
+	}
+	return out;
+}
+
+// White noise from a fixed-seed xorshift32, uniform in [-amplitude, amplitude]
+inline std::vector<float> noise(const size_t samples, const float amplitude = 0.5f,
+								uint32_t seed = 0x9e3779b9u) {
+	std::vector<float> out(samples);
+	for (size_t i = 0; i < samples; ++i) {
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		out[i] = amplitude * (static_cast<float>(seed) / 2147483648.0f - 1.0f);
+	}
+	return out;
+}
+
+// C major triad across three octaves with the harmonics a real instrument would add
+inline std::vector<float> richChord(const size_t samples) {
+	static constexpr float frequencies[] = {130.81f, 164.81f, 196.00f, 261.63f, 329.63f,
+											392.00f, 523.25f, 659.26f, 783.99f, 1046.50f};
+	auto out = chord(samples, frequencies);
+	const auto hiss = noise(samples, 0.01f);
+	for (size_t i = 0; i < samples; ++i) {
+		out[i] += hiss[i];
+	}
+	return out;
+}
+
+// Log-spaced frequencies in the audible range with a 1/f magnitude roll-off
+inline void peakSet(const size_t count, std::vector<float>& frequencies,
+					std::vector<float>& magnitudes) {
+	frequencies.resize(count);
+	magnitudes.resize(count);
+	for (size_t i = 0; i < count; ++i) {
+		const float t = count > 1 ? static_cast<float>(i) / static_cast<float>(count - 1) : 0.5f;
+		frequencies[i] = 40.0f * std::pow(400.0f, t);
+		magnitudes[i] = 1.0f / (1.0f + static_cast<float>(i));
+	}
+}
+
+}
@@ -0,0 +1,61 @@
+#include "bench_signals.h"
+#include "colour_mapper.h"
+#include "fft_processor.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+namespace {
+
+void BM_FrequenciesToColour(benchmark::State& state) {
+	std::vector<float> frequencies;
+	std::vector<float> magnitudes;
+	BenchSignals::peakSet(static_cast<size_t>(state.range(0)), frequencies, magnitudes);
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ColourMapper::frequenciesToColour(frequencies, magnitudes, {},
+																   BenchSignals::SAMPLE_RATE));
+	}
+	state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_FrequenciesToColour)->Arg(1)->Arg(10)->Arg(100)->ArgNames({"peaks"});
+
+// The full-spectrum path the UI takes every frame, envelope straight out of the FFT
+void BM_FrequenciesToColourEnvelope(benchmark::State& state) {
+	FFTProcessor processor;
+	processor.processBuffer(BenchSignals::richChord(FFTProcessor::FFT_SIZE),
+							BenchSignals::SAMPLE_RATE, std::chrono::steady_clock::now());
+	const auto envelope = processor.getSpectralEnvelope();
+
+	std::vector<float> frequencies;
+	std::vector<float> magnitudes;
+	for (const auto& peak : processor.getDominantFrequencies()) {
+		frequencies.push_back(peak.frequency);
+		magnitudes.push_back(peak.magnitude);
+	}
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(ColourMapper::frequenciesToColour(frequencies, magnitudes, envelope,
+																   BenchSignals::SAMPLE_RATE));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(envelope.size()));
+}
+BENCHMARK(BM_FrequenciesToColourEnvelope);
+
+void BM_CalculateSpectralCharacteristics(benchmark::State& state) {
+	FFTProcessor processor;
+	const auto signal = state.range(0) == 0 ? BenchSignals::noise(FFTProcessor::FFT_SIZE)
+											: BenchSignals::richChord(FFTProcessor::FFT_SIZE);
+	processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, std::chrono::steady_clock::now());
+	const auto magnitudes = processor.getMagnitudesBuffer();
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(
+			ColourMapper::calculateSpectralCharacteristics(magnitudes, BenchSignals::SAMPLE_RATE));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(magnitudes.size()));
+}
+BENCHMARK(BM_CalculateSpectralCharacteristics)->Arg(0)->Arg(1)->ArgNames({"chord"});
+
+}
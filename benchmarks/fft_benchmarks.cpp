@@ -0,0 +1,222 @@
+#include "bench_signals.h"
+#include "fast_math.h"
+#include "fft_backend.h"
+#include "fft_processor.h"
+
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+#include <cmath>
+
+// Reaches the private analysis stages so they can be timed in isolation
+struct FFTProcessorBenchmarkAccess {
+	static const std::vector<float>& magnitudes(const FFTProcessor& processor) {
+		return processor.magnitudesBuffer;
+	}
+
+	static void findPeaks(const FFTProcessor& processor, const float sampleRate,
+						  const float noiseFloor, std::vector<FFTProcessor::FrequencyPeak>& peaks) {
+		processor.findPeaks(sampleRate, noiseFloor, {}, processor.getSpectralFeatures().flatness, peaks);
+	}
+};
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+void BM_ProcessBufferSine(benchmark::State& state) {
+	const auto samples = static_cast<size_t>(state.range(0));
+	const auto signal = BenchSignals::sine(samples, 440.0f);
+	FFTProcessor processor;
+	const auto frameTime = Clock::now();
+
+	for (auto _ : state) {
+		processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, frameTime);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples));
+}
+BENCHMARK(BM_ProcessBufferSine)->RangeMultiplier(2)->Range(256, 8192);
+
+void BM_ProcessBufferChord(benchmark::State& state) {
+	const auto samples = static_cast<size_t>(state.range(0));
+	const auto signal = BenchSignals::richChord(samples);
+	FFTProcessor processor;
+	const auto frameTime = Clock::now();
+
+	for (auto _ : state) {
+		processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, frameTime);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples));
+}
+BENCHMARK(BM_ProcessBufferChord)->RangeMultiplier(2)->Range(256, 8192);
+
+void BM_ProcessBufferNoise(benchmark::State& state) {
+	const auto samples = static_cast<size_t>(state.range(0));
+	const auto signal = BenchSignals::noise(samples);
+	FFTProcessor processor;
+	const auto frameTime = Clock::now();
+
+	for (auto _ : state) {
+		processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, frameTime);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples));
+}
+BENCHMARK(BM_ProcessBufferNoise)->Arg(FFTProcessor::FFT_SIZE);
+
+// The bare forward transform of each backend, at the main and low-band window sizes
+void BM_FFTBackend(benchmark::State& state) {
+	const auto kind = static_cast<FFTBackend::Kind>(state.range(0));
+	const auto size = static_cast<int>(state.range(1));
+	const auto backend = FFTBackend::create(kind, size);
+	const auto signal = BenchSignals::richChord(static_cast<size_t>(size));
+	std::vector<FFTComplex> spectrum(static_cast<size_t>(size / 2 + 1));
+
+	for (auto _ : state) {
+		backend->forward(signal, spectrum);
+		benchmark::DoNotOptimize(spectrum.data());
+	}
+	state.SetLabel(FFTBackend::name(kind));
+	state.SetItemsProcessed(state.iterations() * size);
+}
+BENCHMARK(BM_FFTBackend)
+	->Args({static_cast<int>(FFTBackend::Kind::KissFFT), FFTProcessor::FFT_SIZE})
+	->Args({static_cast<int>(FFTBackend::Kind::KissFFT), LowBandAnalyser::FFT_SIZE})
+#ifdef USE_FFTW_BACKEND
+	->Args({static_cast<int>(FFTBackend::Kind::FFTW), FFTProcessor::FFT_SIZE})
+	->Args({static_cast<int>(FFTBackend::Kind::FFTW), LowBandAnalyser::FFT_SIZE})
+#endif
+	->ArgNames({"backend", "size"});
+
+// The chord with and without the low-band transform, to show what multi-resolution costs
+void BM_ProcessBufferMultiResolution(benchmark::State& state) {
+	const auto signal = BenchSignals::richChord(FFTProcessor::FFT_SIZE);
+	FFTProcessor processor;
+	processor.setMultiResolution(state.range(0) != 0);
+	const auto frameTime = Clock::now();
+
+	for (auto _ : state) {
+		processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, frameTime);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(signal.size()));
+}
+BENCHMARK(BM_ProcessBufferMultiResolution)->Arg(0)->Arg(1)->ArgNames({"multi_res"});
+
+void BM_NoiseFloorEstimate(benchmark::State& state) {
+	FFTProcessor processor;
+	processor.processBuffer(BenchSignals::richChord(FFTProcessor::FFT_SIZE),
+							BenchSignals::SAMPLE_RATE, Clock::now());
+	const auto magnitudes = FFTProcessorBenchmarkAccess::magnitudes(processor);
+	NoiseFloorEstimator estimator;
+
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(estimator.estimate(magnitudes));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(magnitudes.size()));
+}
+BENCHMARK(BM_NoiseFloorEstimate);
+
+void BM_NoiseFloorBinTracking(benchmark::State& state) {
+	FFTProcessor processor;
+	processor.processBuffer(BenchSignals::richChord(FFTProcessor::FFT_SIZE),
+							BenchSignals::SAMPLE_RATE, Clock::now());
+	const auto magnitudes = FFTProcessorBenchmarkAccess::magnitudes(processor);
+	NoiseFloorEstimator estimator;
+
+	for (auto _ : state) {
+		estimator.updateBinFloors(magnitudes);
+		benchmark::DoNotOptimize(estimator.binThresholds().data());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(magnitudes.size()));
+}
+BENCHMARK(BM_NoiseFloorBinTracking);
+
+void BM_SpectralFeatures(benchmark::State& state) {
+	FFTProcessor processor;
+	const auto signal = state.range(0) == 0 ? BenchSignals::noise(FFTProcessor::FFT_SIZE)
+											: BenchSignals::richChord(FFTProcessor::FFT_SIZE);
+	processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, Clock::now());
+	const auto magnitudes = FFTProcessorBenchmarkAccess::magnitudes(processor);
+
+	SpectralFeatureExtractor extractor;
+	for (auto _ : state) {
+		benchmark::DoNotOptimize(extractor.process(
+			magnitudes, BenchSignals::SAMPLE_RATE / FFTProcessor::FFT_SIZE, 0.0f));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(magnitudes.size()));
+}
+BENCHMARK(BM_SpectralFeatures)->Arg(0)->Arg(1)->ArgNames({"chord"});
+
+// The log kernel alone, over one frame's worth of magnitudes
+template <float (*Log)(float)>
+void BM_LogKernel(benchmark::State& state) {
+	const auto values = BenchSignals::noise(FFTProcessor::FFT_SIZE / 2 + 1);
+	std::vector<float> magnitudes(values.size());
+	for (size_t i = 0; i < values.size(); ++i) {
+		magnitudes[i] = std::abs(values[i]) + 1e-6f;
+	}
+
+	for (auto _ : state) {
+		float sum = 0.0f;
+		for (const float magnitude : magnitudes) {
+			sum += Log(magnitude);
+		}
+		benchmark::DoNotOptimize(sum);
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(magnitudes.size()));
+}
+
+float libmLog2(const float x) { return std::log2(x); }
+
+BENCHMARK(BM_LogKernel<libmLog2>)->Name("BM_Log2Libm");
+BENCHMARK(BM_LogKernel<FastMath::log2Approx>)->Name("BM_Log2Approx");
+
+// signal: 0 sine, 1 chord, 2 noise (the densest candidate list for the harmonic sieve)
+void BM_FindPeaks(benchmark::State& state) {
+	FFTProcessor processor;
+	const auto signal = state.range(0) == 0   ? BenchSignals::sine(FFTProcessor::FFT_SIZE, 440.0f)
+						: state.range(0) == 1 ? BenchSignals::richChord(FFTProcessor::FFT_SIZE)
+											  : BenchSignals::noise(FFTProcessor::FFT_SIZE);
+	processor.processBuffer(signal, BenchSignals::SAMPLE_RATE, Clock::now());
+	const float noiseFloor =
+		NoiseFloorEstimator().estimate(FFTProcessorBenchmarkAccess::magnitudes(processor));
+
+	std::vector<FFTProcessor::FrequencyPeak> peaks;
+	peaks.reserve(FFTProcessor::MAX_PEAKS);
+	for (auto _ : state) {
+		peaks.clear();
+		FFTProcessorBenchmarkAccess::findPeaks(processor, BenchSignals::SAMPLE_RATE, noiseFloor, peaks);
+		benchmark::DoNotOptimize(peaks.data());
+	}
+	state.counters["peaks"] = static_cast<double>(peaks.size());
+}
+BENCHMARK(BM_FindPeaks)->Arg(0)->Arg(1)->Arg(2)->ArgNames({"signal"});
+
+// Peak picking on the chord with each sub-bin estimator. Two buffers are analysed first
+// so the phase vocoder has a previous spectrum to work from.
+void BM_PeakInterpolation(benchmark::State& state) {
+	FFTProcessor processor;
+	processor.setPeakInterpolation(static_cast<FFTProcessor::PeakInterpolation>(state.range(0)));
+	const auto signal = BenchSignals::richChord(2 * FFTProcessor::FFT_SIZE);
+	processor.processBuffer(std::span(signal).first(FFTProcessor::FFT_SIZE),
+							BenchSignals::SAMPLE_RATE, Clock::now());
+	processor.processBuffer(std::span(signal).subspan(FFTProcessor::FFT_SIZE),
+							BenchSignals::SAMPLE_RATE, Clock::now());
+	const float noiseFloor =
+		NoiseFloorEstimator().estimate(FFTProcessorBenchmarkAccess::magnitudes(processor));
+
+	std::vector<FFTProcessor::FrequencyPeak> peaks;
+	peaks.reserve(FFTProcessor::MAX_PEAKS);
+	for (auto _ : state) {
+		peaks.clear();
+		FFTProcessorBenchmarkAccess::findPeaks(processor, BenchSignals::SAMPLE_RATE, noiseFloor, peaks);
+		benchmark::DoNotOptimize(peaks.data());
+	}
+	state.counters["peaks"] = static_cast<double>(peaks.size());
+}
+BENCHMARK(BM_PeakInterpolation)->DenseRange(0, 2)->ArgNames({"method"});
+
+}
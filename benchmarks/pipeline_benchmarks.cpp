@@ -0,0 +1,248 @@
+#include "allocation_counter.h"
+#include "audio_processor.h"
+#include "bench_signals.h"
+#include "decimator.h"
+#include "signal_conditioner.h"
+#include "smoothing.h"
+#include "zero_crossing.h"
+
+#ifdef ENABLE_API_SERVER
+#include "serialisation.h"
+#endif
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+// One 60 Hz UI frame per iteration, retargeted every few frames like a live signal would
+void BM_SpringSmootherUpdate(benchmark::State& state) {
+	SpringSmoother smoother;
+	smoother.reset(0.0f, 0.0f, 0.0f);
+	smoother.setSmoothingAmount(0.6f);
+
+	static constexpr float targets[][3] = {
+		{1.0f, 0.2f, 0.1f}, {0.1f, 0.8f, 0.3f}, {0.2f, 0.3f, 1.0f}, {0.9f, 0.9f, 0.2f}};
+	size_t frame = 0;
+	for (auto _ : state) {
+		if (frame % 8 == 0) {
+			const auto& target = targets[(frame / 8) % 4];
+			smoother.setTargetColour(target[0], target[1], target[2]);
+		}
+		benchmark::DoNotOptimize(smoother.update(1.0f / 60.0f));
+		++frame;
+	}
+}
+BENCHMARK(BM_SpringSmootherUpdate);
+
+void BM_ZeroCrossingProcessSamples(benchmark::State& state) {
+	const auto samples = static_cast<size_t>(state.range(0));
+	const auto signal = BenchSignals::richChord(samples);
+	ZeroCrossingDetector detector;
+
+	for (auto _ : state) {
+		detector.processSamples(signal.data(), signal.size());
+		benchmark::DoNotOptimize(detector.getEstimatedFrequency());
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(samples));
+}
+BENCHMARK(BM_ZeroCrossingProcessSamples)->RangeMultiplier(4)->Range(256, 4096);
+
+// Conditioning every channel of an interleaved capture block: one pass per channel with
+// process(), against the single deinterleaving pass of processAll()
+void BM_ConditionChannels(benchmark::State& state) {
+	const auto channels = static_cast<int>(state.range(0));
+	const bool singlePass = state.range(1) != 0;
+	constexpr size_t FRAMES = FFTProcessor::FFT_SIZE;
+	const auto interleaved = BenchSignals::noise(FRAMES * static_cast<size_t>(channels));
+
+	SignalConditioner conditioner(channels);
+	std::vector<std::vector<float>> outputs(static_cast<size_t>(channels), std::vector<float>(FRAMES));
+	std::vector<float*> outputPointers;
+	for (auto& output : outputs) {
+		outputPointers.push_back(output.data());
+	}
+
+	for (auto _ : state) {
+		if (singlePass) {
+			conditioner.processAll(interleaved.data(), FRAMES, channels, outputPointers);
+		} else {
+			for (int c = 0; c < channels; ++c) {
+				conditioner.process(interleaved.data(), FRAMES, channels, c,
+									outputPointers[static_cast<size_t>(c)]);
+			}
+		}
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(interleaved.size()));
+}
+BENCHMARK(BM_ConditionChannels)
+	->ArgsProduct({{1, 2, 8}, {0, 1}})
+	->ArgNames({"channels", "single_pass"});
+
+// The factor --decimate auto picks for the rates below: down to 44.1 or 48 kHz
+int autoDecimation(const int captureRate) { return captureRate >= 176400 ? 4 : 2; }
+
+// Filtering one capture block down for analysis. Decimating 96 or 192 kHz capture trades
+// this for one half or three quarters of the analysis frames the full rate would need; the
+// 44.1 kHz family's narrower transition needs about twice the taps.
+void BM_Decimate(benchmark::State& state) {
+	constexpr size_t FRAMES = FFTProcessor::FFT_SIZE;
+	const auto captureRate = static_cast<int>(state.range(0));
+	const auto signal = BenchSignals::noise(FRAMES);
+	Decimator decimator;
+	decimator.configure(autoDecimation(captureRate), captureRate, FRAMES);
+	std::vector<float> block(FRAMES);
+
+	for (auto _ : state) {
+		std::ranges::copy(signal, block.begin());
+		benchmark::DoNotOptimize(decimator.process(block.data(), FRAMES));
+	}
+	state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(FRAMES));
+	state.counters["taps"] = static_cast<double>(decimator.getTapCount());
+}
+BENCHMARK(BM_Decimate)->Arg(88200)->Arg(96000)->Arg(176400)->Arg(192000)->ArgNames({"rate"});
+
+// Not a timing: measures the decimation filter by running tones through it, and fails if
+// the passband droops more than 0.1 dB by MAX_FREQ or anything that would alias below
+// MAX_FREQ is less than 70 dB down
+void BM_DecimatorResponse(benchmark::State& state) {
+	constexpr size_t BLOCK = FFTProcessor::FFT_SIZE;
+	constexpr size_t BLOCKS = 4;
+	const auto captureRate = static_cast<float>(state.range(0));
+	const int factor = autoDecimation(static_cast<int>(state.range(0)));
+	const float outputRate = captureRate / static_cast<float>(factor);
+
+	Decimator decimator;
+	decimator.configure(factor, static_cast<double>(captureRate), BLOCK);
+	// Output level of a full-scale tone relative to its input, past the filter's settling
+	const auto gainDb = [&](const float frequency) {
+		// Phase in double: float phase error alone sits near the levels being measured
+		const double step = 2.0 * std::numbers::pi * static_cast<double>(frequency) /
+							static_cast<double>(captureRate);
+		std::vector<float> tone(BLOCK * BLOCKS);
+		for (size_t i = 0; i < tone.size(); ++i) {
+			tone[i] = static_cast<float>(std::sin(step * static_cast<double>(i)));
+		}
+		std::vector<float> block(BLOCK);
+		const size_t settled = decimator.getTapCount() / static_cast<size_t>(factor) + 1;
+		size_t outputs = 0;
+		double power = 0.0;
+		decimator.reset();
+		for (size_t start = 0; start < tone.size(); start += BLOCK) {
+			std::copy_n(tone.begin() + static_cast<std::ptrdiff_t>(start), BLOCK, block.begin());
+			const size_t produced = decimator.process(block.data(), BLOCK);
+			for (size_t i = 0; i < produced; ++i, ++outputs) {
+				if (outputs >= settled) {
+					power += static_cast<double>(block[i]) * static_cast<double>(block[i]);
+				}
+			}
+		}
+		return 10.0 * std::log10(2.0 * power / static_cast<double>(outputs - settled));
+	};
+
+	double passbandDb = 0.0;
+	double aliasDb = -300.0;
+	for (auto _ : state) {
+		passbandDb = 0.0;
+		for (float frequency = 1000.0f; frequency <= FFTProcessor::MAX_FREQ; frequency += 1000.0f) {
+			passbandDb = std::min(passbandDb, gainDb(frequency));
+		}
+		aliasDb = -300.0;
+		for (float frequency = outputRate - FFTProcessor::MAX_FREQ; frequency < captureRate / 2.0f;
+			 frequency += 250.0f) {
+			aliasDb = std::max(aliasDb, gainDb(frequency));
+		}
+	}
+
+	state.counters["passband_db"] = passbandDb;
+	state.counters["alias_db"] = aliasDb;
+	state.counters["taps"] = static_cast<double>(decimator.getTapCount());
+	if (passbandDb < -0.1 || aliasDb > -70.0) {
+		state.SkipWithError("decimation filter misses its passband or alias rejection");
+	}
+}
+BENCHMARK(BM_DecimatorResponse)
+	->Arg(88200)
+	->Arg(96000)
+	->Arg(176400)
+	->Arg(192000)
+	->ArgNames({"rate"})
+	->Iterations(1)
+	->Unit(benchmark::kMillisecond);
+
+// The whole analysis pass, cycling through signals that change the peak count and take
+// the peak-retention path. Fails if any frame allocates once the processor is warm.
+void BM_AnalyseSteadyStateAllocations(benchmark::State& state) {
+	const std::vector<std::vector<float>> signals = {
+		BenchSignals::richChord(FFTProcessor::FFT_SIZE),
+		BenchSignals::noise(FFTProcessor::FFT_SIZE),
+		BenchSignals::sine(FFTProcessor::FFT_SIZE, 440.0f),
+		std::vector<float>(FFTProcessor::FFT_SIZE, 0.0f)};
+	const auto hop = std::chrono::duration_cast<AudioProcessor::Clock::duration>(
+		std::chrono::duration<float>(FFTProcessor::FFT_SIZE / BenchSignals::SAMPLE_RATE));
+
+	AudioProcessor processor;
+	processor.getFFTProcessor().setNoiseFloorMode(state.range(0) != 0
+													  ? FFTProcessor::NoiseFloorMode::PerBin
+													  : FFTProcessor::NoiseFloorMode::Global);
+	processor.getFFTProcessor().setMultiResolution(state.range(1) != 0);
+	auto frameTime = AudioProcessor::Clock::now();
+	size_t frame = 0;
+	const auto analyseNext = [&] {
+		const auto& signal = signals[frame++ % signals.size()];
+		processor.analyse(signal.data(), signal.size(), BenchSignals::SAMPLE_RATE, frameTime);
+		frameTime += hop;
+	};
+
+	// Lets thread-local tables and the feature history reach their working size
+	for (size_t i = 0; i < 4 * signals.size(); ++i) {
+		analyseNext();
+	}
+
+	const uint64_t before = BenchAllocations::count();
+	for (auto _ : state) {
+		analyseNext();
+	}
+	const uint64_t allocations = BenchAllocations::count() - before;
+
+	state.counters["allocs_per_frame"] =
+		benchmark::Counter(static_cast<double>(allocations), benchmark::Counter::kAvgIterations);
+	if (allocations > 0) {
+		state.SkipWithError("analysis allocated after warm-up");
+	}
+}
+BENCHMARK(BM_AnalyseSteadyStateAllocations)
+	->ArgsProduct({{0, 1}, {0, 1}})
+	->ArgNames({"per_bin", "multi_res"});
+
+#ifdef ENABLE_API_SERVER
+void BM_SerialiseColourDataIntoBuffer(benchmark::State& state) {
+	using namespace Synesthesia::API;
+
+	std::vector<float> frequencies;
+	std::vector<float> magnitudes;
+	BenchSignals::peakSet(static_cast<size_t>(state.range(0)), frequencies, magnitudes);
+
+	std::vector<ColourData> colours(frequencies.size());
+	for (size_t i = 0; i < colours.size(); ++i) {
+		colours[i] = {frequencies[i], 550.0f, 0.5f, 0.4f, 0.3f, magnitudes[i], 0.0f};
+	}
+
+	std::vector<uint8_t> buffer;
+	uint32_t sequence = 0;
+	for (auto _ : state) {
+		MessageSerialiser::serialiseColourDataIntoBuffer(buffer, colours, 44100, 2048,
+														 1'000'000, sequence++);
+		benchmark::DoNotOptimize(buffer.data());
+	}
+	state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(buffer.size()));
+}
+BENCHMARK(BM_SerialiseColourDataIntoBuffer)->Arg(1)->Arg(10)->Arg(100)->ArgNames({"colours"});
+#endif
+
+}
@@ -0,0 +1,30 @@
+if(NOT BUILD_BENCHMARKS)
+    return()
+endif()
+
+find_package(benchmark REQUIRED)
+message(STATUS "Found Google Benchmark ${benchmark_VERSION}")
+
+set(BENCHMARK_DIR "${CMAKE_CURRENT_SOURCE_DIR}/benchmarks")
+
+set(BENCHMARK_SOURCES
+    ${BENCHMARK_DIR}/fft_benchmarks.cpp
+    ${BENCHMARK_DIR}/colour_benchmarks.cpp
+    ${BENCHMARK_DIR}/pipeline_benchmarks.cpp
+    ${BENCHMARK_DIR}/allocation_counter.cpp
+    ${SRC_DIR}/ui/smoothing/smoothing.cpp
+)
+
+add_executable(synesthesia_bench ${BENCHMARK_SOURCES})
+
+target_include_directories(synesthesia_bench PRIVATE
+    ${BENCHMARK_DIR}
+    ${SRC_DIR}/ui/smoothing
+)
+
+target_compile_options(synesthesia_bench PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
+target_link_libraries(synesthesia_bench PRIVATE synesthesia_core benchmark::benchmark_main)
+
+set_target_properties(synesthesia_bench PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}
+)
@@ -0,0 +1,54 @@
+if(WIN32)
+    set(SYNESTHESIA_COMPILE_OPTIONS
+        $<$<CONFIG:Release>:/O2>
+        $<$<CONFIG:Release>:/GL>
+    )
+elseif(APPLE)
+    set(SYNESTHESIA_COMPILE_OPTIONS
+        "-Wall" "-Wextra" "-Wformat" "-Wpedantic"
+        "-Wunused" "-Wuninitialized" "-Wshadow"
+        "-Wconversion" "-Wsign-conversion" "-Wfloat-conversion"
+        "-Wnull-dereference" "-Wdouble-promotion"
+        "-Wmissing-include-dirs" "-Wundef" "-Wredundant-decls"
+        "-Woverloaded-virtual" "-Wnon-virtual-dtor"
+        "-O3" "-ffast-math" "-march=native"
+    )
+else()
+    set(SYNESTHESIA_COMPILE_OPTIONS
+        "-Wall" "-Wextra" "-Wformat" "-Wpedantic"
+        "-O3" "-ffast-math" "-march=native"
+    )
+endif()
+
+add_library(synesthesia_core STATIC ${CORE_SOURCES})
+
+target_include_directories(synesthesia_core PUBLIC ${CORE_INCLUDE_DIRS})
+target_compile_options(synesthesia_core PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
+target_compile_features(synesthesia_core PUBLIC cxx_std_20)
+
+if(ENABLE_API_SERVER)
+    target_compile_definitions(synesthesia_core PUBLIC ENABLE_API_SERVER)
+endif()
+
+if(ENABLE_FAST_MATH_KERNELS)
+    target_compile_definitions(synesthesia_core PUBLIC USE_FAST_MATH_KERNELS)
+endif()
+
+target_link_libraries(synesthesia_core PUBLIC
+    ${PORTAUDIO_TARGET}
+    vendor_kissfft
+)
+
+if(ENABLE_FFTW_BACKEND)
+    target_compile_definitions(synesthesia_core PUBLIC USE_FFTW_BACKEND)
+    target_link_libraries(synesthesia_core PUBLIC PkgConfig::FFTW3F)
+endif()
+
+if(UNIX)
+    target_link_libraries(synesthesia_core PUBLIC pthread m)
+endif()
+
+if(UNIX AND NOT APPLE)
+    target_include_directories(synesthesia_core PUBLIC ${ALSA_INCLUDE_DIRS})
+    target_link_libraries(synesthesia_core PUBLIC ${ALSA_LIBRARIES})
+endif()
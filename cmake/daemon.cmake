@@ -0,0 +1,31 @@
+if(NOT (APPLE OR UNIX))
+    return()
+endif()
+
+set(DAEMON_NAME "synesthesia-daemon")
+
+add_executable(${DAEMON_NAME}
+    ${SRC_DIR}/daemon/main.cpp
+    ${SRC_DIR}/cli/cli.cpp
+    ${SRC_DIR}/cli/daemon.cpp
+)
+
+target_include_directories(${DAEMON_NAME} PRIVATE
+    ${SRC_DIR}/cli
+    ${CMAKE_BINARY_DIR}
+)
+
+target_compile_options(${DAEMON_NAME} PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
+target_link_libraries(${DAEMON_NAME} PRIVATE synesthesia_core)
+
+if(APPLE)
+    set_property(SOURCE ${SRC_DIR}/cli/daemon.cpp APPEND PROPERTY COMPILE_OPTIONS "-Wno-c99-extensions")
+endif()
+
+set_target_properties(${DAEMON_NAME} PROPERTIES
+    RUNTIME_OUTPUT_DIRECTORY ${CMAKE_BINARY_DIR}
+)
+
+install(TARGETS ${DAEMON_NAME}
+    RUNTIME DESTINATION bin
+)
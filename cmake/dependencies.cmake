@@ -33,6 +33,12 @@ if(EXISTS "${PORTAUDIO_DIR}/CMakeLists.txt")
     endif()
 endif()
 
+if(ENABLE_FFTW_BACKEND)
+    find_package(PkgConfig REQUIRED)
+    pkg_check_modules(FFTW3F REQUIRED IMPORTED_TARGET fftw3f)
+    message(STATUS "Found FFTW3 (single precision): ${FFTW3F_VERSION}")
+endif()
+
 if(UNIX AND NOT APPLE)
     find_package(Vulkan REQUIRED)
     message(STATUS "Found Vulkan: ${Vulkan_LIBRARIES}")
@@ -31,21 +31,23 @@ endif()
 
 function(add_neon_sources)
     if(NEON_AVAILABLE AND ENABLE_NEON_OPTIMISATIONS)
-        list(APPEND SOURCES
+        list(APPEND CORE_SOURCES
             ${SRC_DIR}/fft/fft_processor_neon.cpp
             ${SRC_DIR}/colour/colour_mapper_neon.cpp
         )
-        set(SOURCES ${SOURCES} PARENT_SCOPE)
+        set(CORE_SOURCES ${CORE_SOURCES} PARENT_SCOPE)
         message(STATUS "Added NEON-optimised source files to build")
     endif()
 endfunction()
 
 function(apply_neon_optimisations)
     if(APPLE AND NEON_AVAILABLE AND ENABLE_NEON_OPTIMISATIONS)
-        target_compile_options(${EXECUTABLE_NAME} PRIVATE
-            "-mcpu=apple-m1"
-            "-mtune=apple-m1"
-        )
+        foreach(target ${EXECUTABLE_NAME} synesthesia_core)
+            target_compile_options(${target} PRIVATE
+                "-mcpu=apple-m1"
+                "-mtune=apple-m1"
+            )
+        endforeach()
 
         set_source_files_properties(
             ${SRC_DIR}/fft/fft_processor_neon.cpp
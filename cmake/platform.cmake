@@ -31,6 +31,8 @@ endif()
 if(APPLE OR UNIX)
     list(APPEND SOURCES
         ${SRC_DIR}/cli/cli.cpp
+        ${SRC_DIR}/cli/daemon.cpp
+        ${SRC_DIR}/cli/frame_stream.cpp
         ${SRC_DIR}/cli/headless.cpp
     )
     if(APPLE)
@@ -53,25 +55,14 @@ else()
 endif()
 
 if(WIN32)
-    target_compile_options(${EXECUTABLE_NAME} PRIVATE
-        $<$<CONFIG:Release>:/O2>
-        $<$<CONFIG:Release>:/GL>
-    )
+    target_compile_options(${EXECUTABLE_NAME} PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
     target_link_options(${EXECUTABLE_NAME} PRIVATE
         $<$<CONFIG:Release>:/LTCG>
         $<$<CONFIG:Release>:/SUBSYSTEM:WINDOWS>
         $<$<CONFIG:Release>:/ENTRY:mainCRTStartup>
     )
 elseif(APPLE)
-    target_compile_options(${EXECUTABLE_NAME} PRIVATE
-        "-Wall" "-Wextra" "-Wformat" "-Wpedantic"
-        "-Wunused" "-Wuninitialized" "-Wshadow"
-        "-Wconversion" "-Wsign-conversion" "-Wfloat-conversion"
-        "-Wnull-dereference" "-Wdouble-promotion"
-        "-Wmissing-include-dirs" "-Wundef" "-Wredundant-decls"
-        "-Woverloaded-virtual" "-Wnon-virtual-dtor"
-        "-O3" "-ffast-math" "-march=native"
-    )
+    target_compile_options(${EXECUTABLE_NAME} PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
 
     set_source_files_properties(${SRC_DIR}/renderers/metal/main.mm PROPERTIES COMPILE_FLAGS "${OBJC_FLAGS}")
     set_source_files_properties(${SRC_DIR}/ui/styling/system_theme/system_theme_detector.mm PROPERTIES COMPILE_FLAGS "${OBJC_FLAGS}")
@@ -84,11 +75,9 @@ elseif(APPLE)
     set_property(SOURCE ${SRC_DIR}/api/server/api_server.cpp APPEND PROPERTY COMPILE_OPTIONS "-Wno-c99-extensions")
     set_property(SOURCE ${SRC_DIR}/api/synesthesia_api_integration.cpp APPEND PROPERTY COMPILE_OPTIONS "-Wno-c99-extensions")
     set_property(SOURCE ${SRC_DIR}/cli/headless.cpp APPEND PROPERTY COMPILE_OPTIONS "-Wno-c99-extensions")
+    set_property(SOURCE ${SRC_DIR}/cli/frame_stream.cpp APPEND PROPERTY COMPILE_OPTIONS "-Wno-c99-extensions")
 else()
-    target_compile_options(${EXECUTABLE_NAME} PRIVATE
-        "-Wall" "-Wextra" "-Wformat" "-Wpedantic"
-        "-O3" "-ffast-math" "-march=native"
-    )
+    target_compile_options(${EXECUTABLE_NAME} PRIVATE ${SYNESTHESIA_COMPILE_OPTIONS})
 endif()
 
 if(APPLE)
@@ -107,36 +96,33 @@ if(APPLE)
         ${COREVIDEO_FRAMEWORK}
         ${QUARTZCORE_FRAMEWORK}
         ${GLFW_TARGET}
-        ${PORTAUDIO_TARGET}
+        synesthesia_core
         nlohmann_json::nlohmann_json
         vendor_imgui
         vendor_implot
-        vendor_kissfft
         vendor_imgui_backends
         m
     )
 elseif(WIN32)
     target_link_libraries(${EXECUTABLE_NAME} PRIVATE
         ${GLFW_TARGET}
-        ${PORTAUDIO_TARGET}
+        synesthesia_core
         ${DX12_LIBS}
         nlohmann_json::nlohmann_json
         vendor_imgui
         vendor_implot
-        vendor_kissfft
         vendor_imgui_backends
         windowsapp
     )
 else()
     target_link_libraries(${EXECUTABLE_NAME} PRIVATE
         ${GLFW_TARGET}
-        ${PORTAUDIO_TARGET}
+        synesthesia_core
         Vulkan::Vulkan
         ${ALSA_LIBRARIES}
         nlohmann_json::nlohmann_json
         vendor_imgui
         vendor_implot
-        vendor_kissfft
         vendor_imgui_backends
         dl
         pthread
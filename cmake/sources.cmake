@@ -1,10 +1,46 @@
-set(SOURCES
-    ${SRC_DIR}/main.cpp
+# Analysis engine, built as synesthesia_core. Nothing here may depend on ImGui, GLFW or a
+# renderer so headless builds and the benchmarks can link it on its own.
+set(CORE_SOURCES
     ${SRC_DIR}/zero_crossing/zero_crossing.cpp
     ${SRC_DIR}/audio/audio_input.cpp
     ${SRC_DIR}/audio/audio_processor.cpp
+    ${SRC_DIR}/audio/decimator.cpp
+    ${SRC_DIR}/audio/signal_conditioner.cpp
     ${SRC_DIR}/colour/colour_mapper.cpp
+    ${SRC_DIR}/colour/envelope_colour_mapper.cpp
+    ${SRC_DIR}/fft/fft_backend.cpp
     ${SRC_DIR}/fft/fft_processor.cpp
+    ${SRC_DIR}/fft/harmonic_sieve.cpp
+    ${SRC_DIR}/fft/low_band_analyser.cpp
+    ${SRC_DIR}/fft/noise_floor.cpp
+    ${SRC_DIR}/fft/spectral_features.cpp
+    ${SRC_DIR}/metrics/metrics.cpp
+    ${SRC_DIR}/offline/wav_reader.cpp
+    ${SRC_DIR}/offline/frame_writer.cpp
+    ${SRC_DIR}/offline/offline_analyser.cpp
+)
+
+if(APPLE OR UNIX)
+    list(APPEND CORE_SOURCES
+        ${SRC_DIR}/metrics/metrics_endpoint.cpp
+        ${SRC_DIR}/offline/mapped_file.cpp
+        ${SRC_DIR}/offline/batch_analyser.cpp
+    )
+endif()
+
+set(CORE_INCLUDE_DIRS
+    ${KISSFFT_DIR}
+    ${SRC_DIR}
+    ${SRC_DIR}/audio
+    ${SRC_DIR}/colour
+    ${SRC_DIR}/fft
+    ${SRC_DIR}/metrics
+    ${SRC_DIR}/offline
+    ${SRC_DIR}/zero_crossing
+)
+
+set(SOURCES
+    ${SRC_DIR}/main.cpp
     ${SRC_DIR}/ui/controls/controls.cpp
     ${SRC_DIR}/ui/device_manager/device_manager.cpp
     ${SRC_DIR}/ui/updating/update.cpp
@@ -16,27 +52,38 @@ set(SOURCES
 
 function(add_api_sources)
     if(ENABLE_API_SERVER)
-        list(APPEND SOURCES
+        list(APPEND CORE_SOURCES
             ${SRC_DIR}/api/common/serialisation.cpp
             ${SRC_DIR}/api/common/transport.cpp
             ${SRC_DIR}/api/server/api_server.cpp
             ${SRC_DIR}/api/synesthesia_api_integration.cpp
         )
-        set(SOURCES ${SOURCES} PARENT_SCOPE)
+        list(APPEND CORE_INCLUDE_DIRS
+            ${SRC_DIR}/api
+            ${SRC_DIR}/api/common
+            ${SRC_DIR}/api/server
+            ${SRC_DIR}/api/client
+            ${SRC_DIR}/api/protocol
+        )
+        set(CORE_SOURCES ${CORE_SOURCES} PARENT_SCOPE)
+        set(CORE_INCLUDE_DIRS ${CORE_INCLUDE_DIRS} PARENT_SCOPE)
         message(STATUS "Added API server sources to build")
     endif()
 endfunction()
 
+function(add_fftw_sources)
+    if(ENABLE_FFTW_BACKEND)
+        list(APPEND CORE_SOURCES ${SRC_DIR}/fft/fftw_backend.cpp)
+        set(CORE_SOURCES ${CORE_SOURCES} PARENT_SCOPE)
+        message(STATUS "Added FFTW backend to build")
+    endif()
+endfunction()
+
 function(configure_include_directories)
     target_include_directories(${EXECUTABLE_NAME} PRIVATE
         ${IMGUI_DIR}
         ${IMGUI_DIR}/backends
         ${IMPLOT_DIR}
-        ${KISSFFT_DIR}
-        ${SRC_DIR}
-        ${SRC_DIR}/audio
-        ${SRC_DIR}/colour
-        ${SRC_DIR}/fft
         ${SRC_DIR}/ui/controls
         ${SRC_DIR}/ui/device_manager
         ${SRC_DIR}/ui/updating
@@ -44,19 +91,8 @@ function(configure_include_directories)
         ${SRC_DIR}/ui/styling
         ${SRC_DIR}/ui/styling/system_theme
         ${SRC_DIR}/ui/spectrum_analyser
-        ${SRC_DIR}/zero_crossing
         ${SRC_DIR}/cli
         ${CMAKE_BINARY_DIR}
         /opt/homebrew/include
     )
-
-    if(ENABLE_API_SERVER)
-        target_include_directories(${EXECUTABLE_NAME} PRIVATE
-            ${SRC_DIR}/api
-            ${SRC_DIR}/api/common
-            ${SRC_DIR}/api/server
-            ${SRC_DIR}/api/client
-            ${SRC_DIR}/api/protocol
-        )
-    endif()
 endfunction()
\ No newline at end of file
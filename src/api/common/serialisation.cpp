@@ -9,7 +9,9 @@ std::vector<uint8_t> MessageSerialiser::serialiseColourData(
     uint32_t sample_rate,
     uint32_t fft_size,
     uint64_t frame_timestamp,
-    uint32_t sequence
+    uint32_t sequence,
+    uint16_t channel,
+    uint16_t channel_count
 ) {
     size_t colour_count = std::min(colours.size(), MAX_COLOURS_PER_MESSAGE);
     size_t message_size = sizeof(ColourDataMessage) + colour_count * sizeof(ColourData);
@@ -18,7 +20,7 @@ std::vector<uint8_t> MessageSerialiser::serialiseColourData(
     auto* msg = reinterpret_cast<ColourDataMessage*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::COLOUR_DATA;
     msg->header.length = static_cast<uint16_t>(message_size - sizeof(MessageHeader));
     msg->header.sequence = sequence;
@@ -28,6 +30,8 @@ std::vector<uint8_t> MessageSerialiser::serialiseColourData(
     msg->fft_size = fft_size;
     msg->colour_count = static_cast<uint32_t>(colour_count);
     msg->frame_timestamp = frame_timestamp;
+    msg->channel = channel;
+    msg->channel_count = channel_count;
     
     std::memcpy(msg->colours, colours.data(), colour_count * sizeof(ColourData));
     
@@ -40,7 +44,9 @@ void MessageSerialiser::serialiseColourDataIntoBuffer(
     uint32_t sample_rate,
     uint32_t fft_size,
     uint64_t frame_timestamp,
-    uint32_t sequence
+    uint32_t sequence,
+    uint16_t channel,
+    uint16_t channel_count
 ) {
     size_t colour_count = std::min(colours.size(), MAX_COLOURS_PER_MESSAGE);
     size_t message_size = sizeof(ColourDataMessage) + colour_count * sizeof(ColourData);
@@ -49,7 +55,7 @@ void MessageSerialiser::serialiseColourDataIntoBuffer(
     auto* msg = reinterpret_cast<ColourDataMessage*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::COLOUR_DATA;
     msg->header.length = static_cast<uint16_t>(message_size - sizeof(MessageHeader));
     msg->header.sequence = sequence;
@@ -59,6 +65,8 @@ void MessageSerialiser::serialiseColourDataIntoBuffer(
     msg->fft_size = fft_size;
     msg->colour_count = static_cast<uint32_t>(colour_count);
     msg->frame_timestamp = frame_timestamp;
+    msg->channel = channel;
+    msg->channel_count = channel_count;
     
     if (colour_count > 0) {
         std::memcpy(msg->colours, colours.data(), colour_count * sizeof(ColourData));
@@ -74,7 +82,7 @@ std::vector<uint8_t> MessageSerialiser::serialiseDiscoveryRequest(
     auto* msg = reinterpret_cast<DiscoveryRequest*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::DISCOVERY_REQUEST;
     msg->header.length = sizeof(DiscoveryRequest) - sizeof(MessageHeader);
     msg->header.sequence = sequence;
@@ -99,7 +107,7 @@ std::vector<uint8_t> MessageSerialiser::serialiseDiscoveryResponse(
     auto* msg = reinterpret_cast<DiscoveryResponse*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::DISCOVERY_RESPONSE;
     msg->header.length = sizeof(DiscoveryResponse) - sizeof(MessageHeader);
     msg->header.sequence = sequence;
@@ -128,7 +136,7 @@ std::vector<uint8_t> MessageSerialiser::serialiseConfigUpdate(
     auto* msg = reinterpret_cast<ConfigUpdate*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::CONFIG_UPDATE;
     msg->header.length = sizeof(ConfigUpdate) - sizeof(MessageHeader);
     msg->header.sequence = sequence;
@@ -143,6 +151,72 @@ std::vector<uint8_t> MessageSerialiser::serialiseConfigUpdate(
     return buffer;
 }
 
+std::vector<uint8_t> MessageSerialiser::serialiseStatsRequest(uint32_t sequence) {
+    std::vector<uint8_t> buffer(sizeof(MessageHeader));
+    auto* header = reinterpret_cast<MessageHeader*>(buffer.data());
+    
+    header->magic = 0x53594E45;
+    header->version = PROTOCOL_VERSION;
+    header->type = MessageType::STATS_REQUEST;
+    header->length = 0;
+    header->sequence = sequence;
+    header->timestamp = MessageDeserialiser::getCurrentTimestamp();
+    
+    return buffer;
+}
+
+std::vector<uint8_t> MessageSerialiser::serialiseStatsResponse(
+    const PipelineStats& stats,
+    uint32_t sequence
+) {
+    std::vector<uint8_t> buffer(sizeof(StatsResponse));
+    auto* msg = reinterpret_cast<StatsResponse*>(buffer.data());
+    
+    msg->header.magic = 0x53594E45;
+    msg->header.version = PROTOCOL_VERSION;
+    msg->header.type = MessageType::STATS_RESPONSE;
+    msg->header.length = sizeof(StatsResponse) - sizeof(MessageHeader);
+    msg->header.sequence = sequence;
+    msg->header.timestamp = MessageDeserialiser::getCurrentTimestamp();
+    
+    msg->stats = stats;
+    
+    return buffer;
+}
+
+std::vector<uint8_t> MessageSerialiser::serialiseFeaturesRequest(uint32_t sequence) {
+    std::vector<uint8_t> buffer(sizeof(MessageHeader));
+    auto* header = reinterpret_cast<MessageHeader*>(buffer.data());
+    
+    header->magic = 0x53594E45;
+    header->version = PROTOCOL_VERSION;
+    header->type = MessageType::FEATURES_REQUEST;
+    header->length = 0;
+    header->sequence = sequence;
+    header->timestamp = MessageDeserialiser::getCurrentTimestamp();
+    
+    return buffer;
+}
+
+std::vector<uint8_t> MessageSerialiser::serialiseFeaturesResponse(
+    const FrameFeatures& features,
+    uint32_t sequence
+) {
+    std::vector<uint8_t> buffer(sizeof(FeaturesResponse));
+    auto* msg = reinterpret_cast<FeaturesResponse*>(buffer.data());
+    
+    msg->header.magic = 0x53594E45;
+    msg->header.version = PROTOCOL_VERSION;
+    msg->header.type = MessageType::FEATURES_RESPONSE;
+    msg->header.length = sizeof(FeaturesResponse) - sizeof(MessageHeader);
+    msg->header.sequence = sequence;
+    msg->header.timestamp = MessageDeserialiser::getCurrentTimestamp();
+    
+    msg->features = features;
+    
+    return buffer;
+}
+
 std::vector<uint8_t> MessageSerialiser::serialiseError(
     ErrorCode error_code,
     const std::string& error_message,
@@ -152,7 +226,7 @@ std::vector<uint8_t> MessageSerialiser::serialiseError(
     auto* msg = reinterpret_cast<ErrorResponse*>(buffer.data());
     
     msg->header.magic = 0x53594E45;
-    msg->header.version = 1;
+    msg->header.version = PROTOCOL_VERSION;
     msg->header.type = MessageType::ERROR_RESPONSE;
     msg->header.length = sizeof(ErrorResponse) - sizeof(MessageHeader);
     msg->header.sequence = sequence;
@@ -198,7 +272,9 @@ std::optional<std::vector<ColourData>> MessageDeserialiser::deserialiseColourDat
     std::span<const uint8_t> payload,
     uint32_t& sample_rate,
     uint32_t& fft_size,
-    uint64_t& frame_timestamp
+    uint64_t& frame_timestamp,
+    uint16_t& channel,
+    uint16_t& channel_count
 ) {
     if (payload.size() < sizeof(ColourDataMessage) - sizeof(MessageHeader)) {
         return std::nullopt;
@@ -210,14 +286,17 @@ std::optional<std::vector<ColourData>> MessageDeserialiser::deserialiseColourDat
     fft_size = *reinterpret_cast<const uint32_t*>(msg_data + 4);
     uint32_t colour_count = *reinterpret_cast<const uint32_t*>(msg_data + 8);
     frame_timestamp = *reinterpret_cast<const uint64_t*>(msg_data + 12);
+    channel = *reinterpret_cast<const uint16_t*>(msg_data + 20);
+    channel_count = *reinterpret_cast<const uint16_t*>(msg_data + 22);
     
-    size_t expected_size = 20 + colour_count * sizeof(ColourData);
+    const size_t colours_offset = sizeof(ColourDataMessage) - sizeof(MessageHeader);
+    size_t expected_size = colours_offset + colour_count * sizeof(ColourData);
     if (payload.size() < expected_size) {
         return std::nullopt;
     }
     
     std::vector<ColourData> colours(colour_count);
-    const auto* colour_data = reinterpret_cast<const ColourData*>(msg_data + 20);
+    const auto* colour_data = reinterpret_cast<const ColourData*>(msg_data + colours_offset);
     std::memcpy(colours.data(), colour_data, colour_count * sizeof(ColourData));
     
     return colours;
@@ -369,12 +448,36 @@ std::optional<ErrorResponse> MessageDeserialiser::deserialiseError(
     return error;
 }
 
+std::optional<PipelineStats> MessageDeserialiser::deserialiseStats(
+    std::span<const uint8_t> payload
+) {
+    if (payload.size() < sizeof(PipelineStats)) {
+        return std::nullopt;
+    }
+    
+    PipelineStats stats;
+    std::memcpy(&stats, payload.data(), sizeof(stats));
+    return stats;
+}
+
+std::optional<FrameFeatures> MessageDeserialiser::deserialiseFeatures(
+    std::span<const uint8_t> payload
+) {
+    if (payload.size() < sizeof(FrameFeatures)) {
+        return std::nullopt;
+    }
+    
+    FrameFeatures features;
+    std::memcpy(&features, payload.data(), sizeof(features));
+    return features;
+}
+
 bool MessageDeserialiser::validateHeader(const MessageHeader& header, size_t total_size) {
     if (header.magic != 0x53594E45) {
         return false;
     }
     
-    if (header.version != 1) {
+    if (header.version != PROTOCOL_VERSION) {
         return false;
     }
     
@@ -14,7 +14,9 @@ public:
         uint32_t sample_rate,
         uint32_t fft_size,
         uint64_t frame_timestamp,
-        uint32_t sequence
+        uint32_t sequence,
+        uint16_t channel = 0,
+        uint16_t channel_count = 1
     );
     
     static void serialiseColourDataIntoBuffer(
@@ -23,7 +25,9 @@ public:
         uint32_t sample_rate,
         uint32_t fft_size,
         uint64_t frame_timestamp,
-        uint32_t sequence
+        uint32_t sequence,
+        uint16_t channel = 0,
+        uint16_t channel_count = 1
     );
     
     static std::vector<uint8_t> serialiseDiscoveryRequest(
@@ -50,6 +54,20 @@ public:
         uint32_t sequence
     );
     
+    static std::vector<uint8_t> serialiseStatsRequest(uint32_t sequence);
+    
+    static std::vector<uint8_t> serialiseStatsResponse(
+        const PipelineStats& stats,
+        uint32_t sequence
+    );
+    
+    static std::vector<uint8_t> serialiseFeaturesRequest(uint32_t sequence);
+    
+    static std::vector<uint8_t> serialiseFeaturesResponse(
+        const FrameFeatures& features,
+        uint32_t sequence
+    );
+    
     static std::vector<uint8_t> serialiseError(
         ErrorCode error_code,
         const std::string& error_message,
@@ -72,7 +90,9 @@ public:
         std::span<const uint8_t> payload,
         uint32_t& sample_rate,
         uint32_t& fft_size,
-        uint64_t& frame_timestamp
+        uint64_t& frame_timestamp,
+        uint16_t& channel,
+        uint16_t& channel_count
     );
     
     static std::optional<DiscoveryRequest> deserialiseDiscoveryRequest(
@@ -87,6 +107,14 @@ public:
         std::span<const uint8_t> payload
     );
     
+    static std::optional<PipelineStats> deserialiseStats(
+        std::span<const uint8_t> payload
+    );
+    
+    static std::optional<FrameFeatures> deserialiseFeatures(
+        std::span<const uint8_t> payload
+    );
+    
     static std::optional<ErrorResponse> deserialiseError(
         std::span<const uint8_t> payload
     );
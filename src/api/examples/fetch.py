@@ -8,12 +8,13 @@ def main():
     
     client = SynesthesiaClient("Fetch Demo")
     
-    def on_colour_data(colours, sample_rate, fft_size, timestamp):
+    def on_colour_data(colours, sample_rate, fft_size, timestamp, channel):
         if colours:
             dominant = max(colours, key=lambda c: c.magnitude)
             rgb = (int(dominant.r * 255), int(dominant.g * 255), int(dominant.b * 255))
             
-            print(f"{dominant.frequency:.1f}Hz → RGB{rgb} (magnitude: {dominant.magnitude:.3f})")
+            prefix = f"[ch {channel}] " if client.channel_count > 1 else ""
+            print(f"{prefix}{dominant.frequency:.1f}Hz → RGB{rgb} (magnitude: {dominant.magnitude:.3f})")
     
     def on_connection(connected, info):
         if connected:
@@ -16,6 +16,10 @@ class MessageType(IntEnum):
     CONFIG_UPDATE = 0x20
     PING = 0x30
     PONG = 0x31
+    STATS_REQUEST = 0x40
+    STATS_RESPONSE = 0x41
+    FEATURES_REQUEST = 0x42
+    FEATURES_RESPONSE = 0x43
     ERROR_RESPONSE = 0xFF
 
 class ErrorCode(IntEnum):
@@ -52,9 +56,37 @@ class ConfigUpdate:
     frequency_range_min: int
     frequency_range_max: int
 
+@dataclass
+class PipelineStats:
+    """Audio lost between capture and analysis; *_timestamp fields are server
+    steady-clock microseconds (same clock as frame timestamps), 0 if never"""
+    dropped_buffers: int
+    last_drop_timestamp: int
+    merged_buffers: int
+    last_merge_timestamp: int
+    truncated_samples: int
+    last_truncation_timestamp: int
+    input_overflows: int
+    last_overflow_timestamp: int
+    input_underflows: int
+    last_underflow_timestamp: int
+    overflow_policy: int  # 0 = drop newest, 1 = drop oldest, 2 = merge
+
+@dataclass
+class FrameFeatures:
+    """Spectral descriptors of the latest analysis frame; frequencies in Hz,
+    frame_timestamp is the frame's capture time in server steady-clock microseconds"""
+    frame_timestamp: int
+    flatness: float  # ~0 tonal .. 1 noise-like
+    centroid: float
+    spread: float
+    rolloff: float   # 85% of the energy lies below this
+    flux: float      # rise since the previous frame, relative to this one
+    rms: float
+
 class MessageHeader:
     MAGIC = 0x53594E45  # "SYNE"
-    VERSION = 1
+    VERSION = 2
     
     def __init__(self, msg_type: MessageType, length: int, sequence: int, timestamp: int):
         self.magic = self.MAGIC
@@ -88,19 +120,23 @@ class SynesthesiaClient:
         # Connection state
         self.connected = False
         self.socket_path = self.DEFAULT_SOCKET_PATH
+        self.channel_count = 1  # as reported by the latest colour data message
         
         # Callbacks
-        self.colour_data_callback: Optional[Callable[[List[ColourData], int, int, int], None]] = None
+        self.colour_data_callback: Optional[Callable[[List[ColourData], int, int, int, int], None]] = None
         self.config_update_callback: Optional[Callable[[ConfigUpdate], None]] = None
         self.connection_callback: Optional[Callable[[bool, str], None]] = None
         self.error_callback: Optional[Callable[[str], None]] = None
+        self.stats_callback: Optional[Callable[[PipelineStats], None]] = None
+        self.features_callback: Optional[Callable[[FrameFeatures], None]] = None
         
         # Threading
         self.running = False
         self.worker_thread: Optional[threading.Thread] = None
         
-    def set_colour_data_callback(self, callback: Callable[[List[ColourData], int, int, int], None]):
-        """Set callback for colour data updates"""
+    def set_colour_data_callback(self, callback: Callable[[List[ColourData], int, int, int, int], None]):
+        """Set callback for colour data updates: (colours, sample_rate, fft_size, timestamp, channel).
+        A multichannel server sends one message per input channel for each frame."""
         self.colour_data_callback = callback
         
     def set_config_update_callback(self, callback: Callable[[ConfigUpdate], None]):
@@ -114,6 +150,14 @@ class SynesthesiaClient:
     def set_error_callback(self, callback: Callable[[str], None]):
         """Set callback for error messages"""
         self.error_callback = callback
+        
+    def set_stats_callback(self, callback: Callable[[PipelineStats], None]):
+        """Set callback for pipeline stats responses"""
+        self.stats_callback = callback
+        
+    def set_features_callback(self, callback: Callable[[FrameFeatures], None]):
+        """Set callback for spectral feature responses"""
+        self.features_callback = callback
     
     def _get_timestamp(self) -> int:
         """Get current timestamp in microseconds"""
@@ -244,6 +288,38 @@ class SynesthesiaClient:
                 self.error_callback(f"Ping error: {e}")
             return False
     
+    def send_stats_request(self) -> bool:
+        """Ask the server for dropped-buffer / overflow counters"""
+        if not self.connected or not self.unix_socket:
+            return False
+        
+        try:
+            header = MessageHeader(MessageType.STATS_REQUEST, 0,
+                                 self._next_sequence(), self._get_timestamp())
+            self.unix_socket.send(header.pack())
+            return True
+            
+        except Exception as e:
+            if self.error_callback:
+                self.error_callback(f"Stats request error: {e}")
+            return False
+    
+    def send_features_request(self) -> bool:
+        """Ask the server for the latest frame's spectral features"""
+        if not self.connected or not self.unix_socket:
+            return False
+        
+        try:
+            header = MessageHeader(MessageType.FEATURES_REQUEST, 0,
+                                 self._next_sequence(), self._get_timestamp())
+            self.unix_socket.send(header.pack())
+            return True
+            
+        except Exception as e:
+            if self.error_callback:
+                self.error_callback(f"Features request error: {e}")
+            return False
+    
     def _worker_loop(self):
         """Main worker loop for receiving messages"""
         buffer = b''
@@ -299,6 +375,10 @@ class SynesthesiaClient:
                 self._handle_config_update(payload)
             elif header.type == MessageType.PONG:
                 print("Received pong")
+            elif header.type == MessageType.STATS_RESPONSE:
+                self._handle_stats_response(payload)
+            elif header.type == MessageType.FEATURES_RESPONSE:
+                self._handle_features_response(payload)
             elif header.type == MessageType.ERROR_RESPONSE:
                 self._handle_error_response(payload)
             else:
@@ -310,13 +390,15 @@ class SynesthesiaClient:
     
     def _handle_colour_data(self, payload: bytes):
         """Handle colour data message"""
-        if len(payload) < 20:
+        if len(payload) < 24:
             return
         
-        sample_rate, fft_size, colour_count, frame_timestamp = struct.unpack('<IIIQ', payload[:20])
+        sample_rate, fft_size, colour_count, frame_timestamp, channel, channel_count = \
+            struct.unpack('<IIIQHH', payload[:24])
+        self.channel_count = channel_count
         
         colours = []
-        offset = 20
+        offset = 24
         
         for i in range(colour_count):
             if offset + 28 > len(payload):  # 7 floats * 4 bytes each
@@ -327,7 +409,7 @@ class SynesthesiaClient:
             offset += 28
         
         if self.colour_data_callback:
-            self.colour_data_callback(colours, sample_rate, fft_size, frame_timestamp)
+            self.colour_data_callback(colours, sample_rate, fft_size, frame_timestamp, channel)
     
     def _handle_config_update(self, payload: bytes):
         """Handle configuration update message"""
@@ -347,6 +429,26 @@ class SynesthesiaClient:
         if self.config_update_callback:
             self.config_update_callback(config)
     
+    def _handle_stats_response(self, payload: bytes):
+        """Handle pipeline stats response message"""
+        if len(payload) < 84:
+            return
+        
+        stats = PipelineStats(*struct.unpack('<10QI', payload[:84]))
+        
+        if self.stats_callback:
+            self.stats_callback(stats)
+    
+    def _handle_features_response(self, payload: bytes):
+        """Handle spectral features response message"""
+        if len(payload) < 32:
+            return
+        
+        features = FrameFeatures(*struct.unpack('<Q6f', payload[:32]))
+        
+        if self.features_callback:
+            self.features_callback(features)
+    
     def _handle_error_response(self, payload: bytes):
         """Handle error response message"""
         if len(payload) < 260:
@@ -372,7 +474,7 @@ def main():
         'start_time': time.time()
     }
     
-    def on_colour_data(colours: List[ColourData], sample_rate: int, fft_size: int, timestamp: int):
+    def on_colour_data(colours: List[ColourData], sample_rate: int, fft_size: int, timestamp: int, channel: int):
         stats['messages_received'] += 1
         stats['colours_received'] += len(colours)
         stats['last_sample_rate'] = sample_rate
@@ -414,12 +516,26 @@ def main():
     def on_error(error: str):
         print(f"ERROR: {error}")
     
+    def on_stats(pipeline: PipelineStats):
+        print(f"\n--- Pipeline Stats ---")
+        print(f"Dropped buffers: {pipeline.dropped_buffers}, merged: {pipeline.merged_buffers}, "
+              f"truncated samples: {pipeline.truncated_samples}")
+        print(f"Input overflows: {pipeline.input_overflows}, underflows: {pipeline.input_underflows}")
+    
+    def on_features(features: FrameFeatures):
+        print(f"\n--- Spectral Features ---")
+        print(f"Centroid: {features.centroid:.0f}Hz, spread: {features.spread:.0f}Hz, "
+              f"rolloff: {features.rolloff:.0f}Hz")
+        print(f"Flatness: {features.flatness:.3f}, flux: {features.flux:.3f}, RMS: {features.rms:.4f}")
+    
     # Create client
     client = SynesthesiaClient("Python Demo v1.0")
     client.set_colour_data_callback(on_colour_data)
     client.set_config_update_callback(on_config_update)
     client.set_connection_callback(on_connection)
     client.set_error_callback(on_error)
+    client.set_stats_callback(on_stats)
+    client.set_features_callback(on_features)
     
     try:
         # Step 1: Find server socket
@@ -477,6 +593,8 @@ def main():
             # Send ping every 30 seconds
             if int(time.time()) % 30 == 0:
                 client.send_ping()
+                client.send_stats_request()
+                client.send_features_request()
     
     except KeyboardInterrupt:
         print("\n\nShutting down...")
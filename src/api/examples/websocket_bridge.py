@@ -170,7 +170,7 @@ class WebSocketBridge:
         """Setup Synesthesia client with callbacks"""
         self.synesthesia_client = SynesthesiaClient("WebSocket Bridge v1.0")
         
-        def on_colour_data(colours: List[ColourData], sample_rate: int, fft_size: int, timestamp: int):
+        def on_colour_data(colours: List[ColourData], sample_rate: int, fft_size: int, timestamp: int, channel: int):
             # Convert to JSON-serializable format
             colour_data = []
             for colour in colours:
@@ -191,6 +191,7 @@ class WebSocketBridge:
                     "sample_rate": sample_rate,
                     "fft_size": fft_size,
                     "timestamp": timestamp,
+                    "channel": channel,
                     "colour_count": len(colours)
                 }
             }
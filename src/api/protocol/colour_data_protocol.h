@@ -7,6 +7,9 @@
 
 namespace Synesthesia::API {
 
+// 2: ColourDataMessage carries the channel it was analysed from
+constexpr uint8_t PROTOCOL_VERSION = 2;
+
 #pragma pack(push, 1)
 
 enum class MessageType : uint8_t {
@@ -16,12 +19,16 @@ enum class MessageType : uint8_t {
     CONFIG_UPDATE = 0x20,
     PING = 0x30,
     PONG = 0x31,
+    STATS_REQUEST = 0x40,
+    STATS_RESPONSE = 0x41,
+    FEATURES_REQUEST = 0x42,
+    FEATURES_RESPONSE = 0x43,
     ERROR_RESPONSE = 0xFF
 };
 
 struct MessageHeader {
     uint32_t magic = 0x53594E45;
-    uint8_t version = 1;
+    uint8_t version = PROTOCOL_VERSION;
     MessageType type;
     uint16_t length;
     uint32_t sequence;
@@ -42,6 +49,8 @@ struct ColourDataMessage {
     uint32_t fft_size;
     uint32_t colour_count;
     uint64_t frame_timestamp;
+    uint16_t channel;        // input channel these colours were analysed from
+    uint16_t channel_count;  // channels streamed; each frame sends one message per channel
     ColourData colours[];
 };
 
@@ -69,6 +78,42 @@ struct ConfigUpdate {
     uint32_t frequency_range_max;
 };
 
+// Timestamps use the same steady-clock microseconds as MessageHeader::timestamp; 0 means never
+struct PipelineStats {
+    uint64_t dropped_buffers;
+    uint64_t last_drop_timestamp;
+    uint64_t merged_buffers;
+    uint64_t last_merge_timestamp;
+    uint64_t truncated_samples;
+    uint64_t last_truncation_timestamp;
+    uint64_t input_overflows;
+    uint64_t last_overflow_timestamp;
+    uint64_t input_underflows;
+    uint64_t last_underflow_timestamp;
+    uint32_t overflow_policy;  // 0 = drop newest, 1 = drop oldest, 2 = merge
+};
+
+struct StatsResponse {
+    MessageHeader header;
+    PipelineStats stats;
+};
+
+// Spectral descriptors of the most recent analysis frame; frequencies in Hz
+struct FrameFeatures {
+    uint64_t frame_timestamp;  // capture time of the frame, as in ColourDataMessage
+    float flatness;            // ~0 tonal .. 1 noise-like
+    float centroid;
+    float spread;
+    float rolloff;             // 85% of the energy lies below this
+    float flux;                // rise in magnitude since the previous frame, relative to this one
+    float rms;
+};
+
+struct FeaturesResponse {
+    MessageHeader header;
+    FrameFeatures features;
+};
+
 struct ErrorResponse {
     MessageHeader header;
     uint32_t error_code;
@@ -91,7 +136,9 @@ enum class Capabilities : uint32_t {
     CONFIG_UPDATES = 0x02,
     REAL_TIME_DISCOVERY = 0x04,
     LAB_COLOUR_SPACE = 0x08,
-    XYZ_COLOUR_SPACE = 0x10
+    XYZ_COLOUR_SPACE = 0x10,
+    PIPELINE_STATS = 0x20,
+    SPECTRAL_FEATURES = 0x40
 };
 
 constexpr size_t MAX_MESSAGE_SIZE = 65536;
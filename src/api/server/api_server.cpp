@@ -7,6 +7,14 @@ namespace Synesthesia::API {
 
 APIServer::APIServer(const ServerConfig& config) 
     : config_(config), 
+      frames_sent_metric_(Metrics::Registry::instance().counter(
+          "synesthesia_api_frames_sent_total", "Colour frames broadcast to API clients")),
+      connected_clients_metric_(Metrics::Registry::instance().gauge(
+          "synesthesia_api_connected_clients", "API clients currently connected")),
+      capture_latency_metric_(Metrics::Registry::instance().histogram(
+          "synesthesia_api_capture_to_send_seconds",
+          "Time from ADC capture to the colour frame being written to clients",
+          Metrics::latencyBucketsSeconds())),
       current_fps_(config.base_fps),
       last_performance_log_(std::chrono::steady_clock::now()),
       last_client_check_(std::chrono::steady_clock::now()) {
@@ -70,6 +78,7 @@ void APIServer::stop() {
     
     std::lock_guard<std::mutex> lock(clients_mutex_);
     connected_clients_.clear();
+    connected_clients_metric_.set(0.0);
 }
 
 bool APIServer::isRunning() const {
@@ -84,31 +93,64 @@ void APIServer::setConfigUpdateCallback(ConfigUpdateCallback callback) {
     config_update_callback_ = std::move(callback);
 }
 
+void APIServer::setStatsProvider(StatsProvider provider) {
+    stats_provider_ = std::move(provider);
+}
+
+void APIServer::setFeaturesProvider(FeaturesProvider provider) {
+    features_provider_ = std::move(provider);
+}
+
 void APIServer::broadcastColourData() {
     if (!colour_data_provider_ || !ipc_transport_) {
         return;
     }
     
-    uint32_t sample_rate, fft_size;
-    uint64_t timestamp;
-    auto colours = colour_data_provider_(sample_rate, fft_size, timestamp);
-    
-    if (colours.empty()) {
-        return;
+    uint16_t channel_count = 1;
+    for (uint16_t channel = 0; channel < channel_count; ++channel) {
+        uint32_t sample_rate, fft_size;
+        uint64_t timestamp;
+        auto colours = colour_data_provider_(channel, channel_count, sample_rate, fft_size, timestamp);
+        
+        if (colours.empty()) {
+            continue;
+        }
+        
+        size_t colour_count = std::min(colours.size(), MAX_COLOURS_PER_MESSAGE);
+        size_t message_size = sizeof(ColourDataMessage) + colour_count * sizeof(ColourData);
+        
+        auto buffer = getBuffer(message_size);
+        
+        MessageSerialiser::serialiseColourDataIntoBuffer(
+            buffer, colours, sample_rate, fft_size, timestamp, sequence_counter_.fetch_add(1),
+            channel, channel_count
+        );
+        
+        sendToClients(std::span<const uint8_t>(buffer.data(), buffer.size()));
+        
+        // timestamp is the ADC capture time of the frame, so this is audio-in to wire-out latency
+        const uint64_t now = MessageDeserialiser::getCurrentTimestamp();
+        if (timestamp > 0 && now >= timestamp) {
+            capture_latency_.record(std::chrono::microseconds(static_cast<int64_t>(now - timestamp)));
+            capture_latency_metric_.observe(static_cast<double>(now - timestamp) / 1e6);
+        }
+        
+        returnBuffer(std::move(buffer));
+    }
+}
+
+void APIServer::sendToClients(std::span<const uint8_t> data) {
+    // Sent one client at a time rather than via broadcastMessage() so failures can be
+    // attributed; client ids are fd-based and get reused, which keeps label cardinality bounded
+    for (const auto& client_id : getConnectedClients()) {
+        if (!ipc_transport_->sendMessage(data, client_id)) {
+            Metrics::Registry::instance()
+                .counter("synesthesia_api_send_failures_total",
+                         "Colour frames that could not be written to a client",
+                         Metrics::label("client", client_id))
+                .increment();
+        }
     }
-    
-    size_t colour_count = std::min(colours.size(), MAX_COLOURS_PER_MESSAGE);
-    size_t message_size = sizeof(ColourDataMessage) + colour_count * sizeof(ColourData);
-    
-    auto buffer = getBuffer(message_size);
-    
-    MessageSerialiser::serialiseColourDataIntoBuffer(
-        buffer, colours, sample_rate, fft_size, timestamp, sequence_counter_.fetch_add(1)
-    );
-    
-    ipc_transport_->broadcastMessage(std::span<const uint8_t>(buffer.data(), buffer.size()));
-    
-    returnBuffer(std::move(buffer));
 }
 
 float APIServer::getAverageFrameTime() const {
@@ -211,6 +253,26 @@ void APIServer::handleIPCMessage(std::span<const uint8_t> data, const std::strin
             break;
         }
         
+        case MessageType::STATS_REQUEST: {
+            if (!stats_provider_) {
+                sendErrorResponse(sender_id, ErrorCode::INVALID_MESSAGE, "Stats unavailable");
+                break;
+            }
+            auto response = MessageSerialiser::serialiseStatsResponse(stats_provider_(), message->sequence);
+            ipc_transport_->sendMessage(response, sender_id);
+            break;
+        }
+        
+        case MessageType::FEATURES_REQUEST: {
+            if (!features_provider_) {
+                sendErrorResponse(sender_id, ErrorCode::INVALID_MESSAGE, "Features unavailable");
+                break;
+            }
+            auto response = MessageSerialiser::serialiseFeaturesResponse(features_provider_(), message->sequence);
+            ipc_transport_->sendMessage(response, sender_id);
+            break;
+        }
+        
         default:
             sendErrorResponse(sender_id, ErrorCode::INVALID_MESSAGE, "Unsupported message type");
             break;
@@ -231,6 +293,7 @@ void APIServer::handleConnectionChange(const std::string& client_id, bool connec
             connected_clients_.erase(it);
         }
     }
+    connected_clients_metric_.set(static_cast<double>(connected_clients_.size()));
 }
 
 void APIServer::handleError(const std::string& /* error_message */) {
@@ -328,6 +391,7 @@ void APIServer::workerLoop() {
         if (has_clients && colour_data_provider_) {
             broadcastColourData();
             frames_sent_.fetch_add(1);
+            frames_sent_metric_.increment();
         }
         
         auto frame_end = std::chrono::steady_clock::now();
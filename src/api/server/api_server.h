@@ -3,6 +3,8 @@
 #include "../common/transport.h"
 #include "../common/serialisation.h"
 #include "../protocol/colour_data_protocol.h"
+#include "../../audio/latency_tracker.h"
+#include "../../metrics/metrics.h"
 #include <memory>
 #include <atomic>
 #include <thread>
@@ -21,7 +23,9 @@ struct ServerConfig {
     uint32_t capabilities = static_cast<uint32_t>(Capabilities::COLOUR_DATA_STREAMING) |
                            static_cast<uint32_t>(Capabilities::CONFIG_UPDATES) |
                            static_cast<uint32_t>(Capabilities::REAL_TIME_DISCOVERY) |
-                           static_cast<uint32_t>(Capabilities::LAB_COLOUR_SPACE);
+                           static_cast<uint32_t>(Capabilities::LAB_COLOUR_SPACE) |
+                           static_cast<uint32_t>(Capabilities::PIPELINE_STATS) |
+                           static_cast<uint32_t>(Capabilities::SPECTRAL_FEATURES);
     size_t max_clients = 16;
     bool enable_discovery = true;
     
@@ -33,8 +37,11 @@ struct ServerConfig {
     size_t buffer_pool_size = 128;
 };
 
-using ColourDataProvider = std::function<std::vector<ColourData>(uint32_t& sample_rate, uint32_t& fft_size, uint64_t& timestamp)>;
+// Called once per channel, starting at 0, until channel reaches the channel_count it reports
+using ColourDataProvider = std::function<std::vector<ColourData>(uint16_t channel, uint16_t& channel_count, uint32_t& sample_rate, uint32_t& fft_size, uint64_t& timestamp)>;
 using ConfigUpdateCallback = std::function<void(const ConfigUpdate& config)>;
+using StatsProvider = std::function<PipelineStats()>;
+using FeaturesProvider = std::function<FrameFeatures()>;
 
 class APIServer {
 public:
@@ -47,6 +54,8 @@ public:
     
     void setColourDataProvider(ColourDataProvider provider);
     void setConfigUpdateCallback(ConfigUpdateCallback callback);
+    void setStatsProvider(StatsProvider provider);
+    void setFeaturesProvider(FeaturesProvider provider);
     
     void broadcastColourData();
     void broadcastConfigUpdate(const ConfigUpdate& config);
@@ -58,6 +67,7 @@ public:
     bool isHighPerformanceMode() const { return high_performance_mode_.load(); }
     float getAverageFrameTime() const;
     uint64_t getTotalFramesSent() const { return frames_sent_.load(); }
+    LatencyTracker::Snapshot getCaptureLatency() const { return capture_latency_.snapshot(); }
 
 private:
     void handleDiscoveryMessage(std::span<const uint8_t> data, const std::string& sender_id);
@@ -67,6 +77,7 @@ private:
     
     void sendDiscoveryResponse(const std::string& client_address);
     void sendErrorResponse(const std::string& client_id, ErrorCode error_code, const std::string& message);
+    void sendToClients(std::span<const uint8_t> data);
     
     void initialiseBufferPool();
     std::vector<uint8_t> getBuffer(size_t size);
@@ -78,6 +89,8 @@ private:
     
     ColourDataProvider colour_data_provider_;
     ConfigUpdateCallback config_update_callback_;
+    StatsProvider stats_provider_;
+    FeaturesProvider features_provider_;
     
     std::atomic<bool> running_{false};
     std::atomic<uint32_t> sequence_counter_{0};
@@ -89,6 +102,10 @@ private:
     std::vector<std::vector<uint8_t>> buffer_pool_;
     
     std::atomic<uint64_t> frames_sent_{0};
+    LatencyTracker capture_latency_;
+    Metrics::Counter& frames_sent_metric_;
+    Metrics::Gauge& connected_clients_metric_;
+    Metrics::Histogram& capture_latency_metric_;
     std::atomic<uint32_t> current_fps_{60};
     std::atomic<bool> high_performance_mode_{false};
     std::chrono::steady_clock::time_point last_performance_log_;
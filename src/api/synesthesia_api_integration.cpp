@@ -4,6 +4,18 @@
 
 namespace Synesthesia {
 
+namespace {
+
+uint64_t toTimestamp(std::chrono::steady_clock::time_point time) {
+    if (time.time_since_epoch().count() == 0) {
+        return 0;
+    }
+    auto duration = std::chrono::duration_cast<std::chrono::microseconds>(time.time_since_epoch()).count();
+    return static_cast<uint64_t>(std::max(duration, static_cast<decltype(duration)>(0)));
+}
+
+}
+
 std::unique_ptr<SynesthesiaAPIIntegration> SynesthesiaAPIIntegration::instance_;
 std::mutex SynesthesiaAPIIntegration::instance_mutex_;
 
@@ -21,12 +33,28 @@ bool SynesthesiaAPIIntegration::startServer(const API::ServerConfig& config) {
     }
     
     api_server_ = std::make_unique<API::APIServer>(config);
-    api_server_->setColourDataProvider([this](uint32_t& sample_rate, uint32_t& fft_size, uint64_t& timestamp) -> std::vector<API::ColourData> {
+    api_server_->setColourDataProvider([this](uint16_t channel, uint16_t& channel_count, uint32_t& sample_rate,
+                                              uint32_t& fft_size, uint64_t& timestamp) -> std::vector<API::ColourData> {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        channel_count = static_cast<uint16_t>(last_channels_.size());
+        if (channel >= last_channels_.size()) {
+            return {};
+        }
+        const auto& last = last_channels_[channel];
+        sample_rate = last.sample_rate;
+        fft_size = last.fft_size;
+        timestamp = last.timestamp;
+        return last.colours;
+    });
+    
+    api_server_->setStatsProvider([this]() {
+        std::lock_guard<std::mutex> lock(data_mutex_);
+        return last_stats_;
+    });
+    
+    api_server_->setFeaturesProvider([this]() {
         std::lock_guard<std::mutex> lock(data_mutex_);
-        sample_rate = last_sample_rate_;
-        fft_size = last_fft_size_;
-        timestamp = last_timestamp_;
-        return last_colour_data_;
+        return last_features_;
     });
     
     api_server_->setConfigUpdateCallback([this](const API::ConfigUpdate& config) {
@@ -61,7 +89,10 @@ void SynesthesiaAPIIntegration::updateFinalColour(float r, float g, float b,
                                                 const std::vector<float>& frequencies, 
                                                 const std::vector<float>& magnitudes,
                                                 uint32_t sample_rate,
-                                                uint32_t fft_size) {
+                                                uint32_t fft_size,
+                                                std::chrono::steady_clock::time_point capture_time,
+                                                uint16_t channel,
+                                                uint16_t channel_count) {
     if (!api_server_ || !api_server_->isRunning()) {
         return;
     }
@@ -121,16 +152,56 @@ void SynesthesiaAPIIntegration::updateFinalColour(float r, float g, float b,
     
     {
         std::lock_guard<std::mutex> lock(data_mutex_);
-        last_colour_data_ = std::move(colour_data);
-        last_sample_rate_ = sample_rate;
-        last_fft_size_ = fft_size;
+        last_channels_.resize(std::max<size_t>({channel_count, channel + 1u, 1u}));
+        auto& last = last_channels_[channel];
+        last.colours = std::move(colour_data);
+        last.sample_rate = sample_rate;
+        last.fft_size = fft_size;
+        // frame_timestamp carries the ADC capture time of the analysed audio (steady clock,
+        // same epoch as the header timestamp), so clients can measure true end-to-end latency.
+        if (capture_time.time_since_epoch().count() == 0) {
+            capture_time = std::chrono::steady_clock::now();
+        }
         auto duration = std::chrono::duration_cast<std::chrono::microseconds>(
-            std::chrono::steady_clock::now().time_since_epoch()
+            capture_time.time_since_epoch()
         ).count();
-        last_timestamp_ = static_cast<uint64_t>(std::max(duration, static_cast<decltype(duration)>(0)));
+        last.timestamp = static_cast<uint64_t>(std::max(duration, static_cast<decltype(duration)>(0)));
     }
 }
 
+void SynesthesiaAPIIntegration::updateCaptureStats(const AudioProcessor::CaptureStats& stats) {
+    API::PipelineStats converted{};
+    converted.dropped_buffers = stats.droppedBuffers.count;
+    converted.last_drop_timestamp = toTimestamp(stats.droppedBuffers.lastOccurrence);
+    converted.merged_buffers = stats.mergedBuffers.count;
+    converted.last_merge_timestamp = toTimestamp(stats.mergedBuffers.lastOccurrence);
+    converted.truncated_samples = stats.truncatedSamples.count;
+    converted.last_truncation_timestamp = toTimestamp(stats.truncatedSamples.lastOccurrence);
+    converted.input_overflows = stats.inputOverflows.count;
+    converted.last_overflow_timestamp = toTimestamp(stats.inputOverflows.lastOccurrence);
+    converted.input_underflows = stats.inputUnderflows.count;
+    converted.last_underflow_timestamp = toTimestamp(stats.inputUnderflows.lastOccurrence);
+    converted.overflow_policy = static_cast<uint32_t>(stats.policy);
+    
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    last_stats_ = converted;
+}
+
+void SynesthesiaAPIIntegration::updateSpectralFeatures(const SpectralFeatures& features,
+                                                       std::chrono::steady_clock::time_point capture_time) {
+    API::FrameFeatures converted{};
+    converted.frame_timestamp = toTimestamp(capture_time);
+    converted.flatness = features.flatness;
+    converted.centroid = features.centroid;
+    converted.spread = features.spread;
+    converted.rolloff = features.rolloff;
+    converted.flux = features.flux;
+    converted.rms = features.rms;
+    
+    std::lock_guard<std::mutex> lock(data_mutex_);
+    last_features_ = converted;
+}
+
 void SynesthesiaAPIIntegration::updateSmoothingConfig(bool enabled, float factor) {
     smoothing_enabled_ = enabled;
     smoothing_factor_ = std::clamp(factor, 0.0f, 1.0f);
@@ -165,7 +236,11 @@ std::vector<std::string> SynesthesiaAPIIntegration::getConnectedClients() const
 
 size_t SynesthesiaAPIIntegration::getLastDataSize() const {
     std::lock_guard<std::mutex> lock(data_mutex_);
-    return last_colour_data_.size();
+    size_t total = 0;
+    for (const auto& channel : last_channels_) {
+        total += channel.colours.size();
+    }
+    return total;
 }
 
 uint32_t SynesthesiaAPIIntegration::getCurrentFPS() const {
@@ -188,6 +263,11 @@ uint64_t SynesthesiaAPIIntegration::getTotalFramesSent() const {
     return api_server_->getTotalFramesSent();
 }
 
+LatencyTracker::Snapshot SynesthesiaAPIIntegration::getCaptureLatency() const {
+    if (!api_server_) return {};
+    return api_server_->getCaptureLatency();
+}
+
 SynesthesiaAPIIntegration& SynesthesiaAPIIntegration::getInstance() {
     std::lock_guard<std::mutex> lock(instance_mutex_);
     if (!instance_) {
@@ -3,7 +3,9 @@
 #include "server/api_server.h"
 #include "client/api_client.h"
 #include "../colour/colour_mapper.h"
+#include "../audio/audio_processor.h"
 #include "../fft/fft_processor.h"
+#include <chrono>
 #include <memory>
 #include <vector>
 #include <mutex>
@@ -25,11 +27,20 @@ public:
     void stopServer();
     bool isServerRunning() const;
     
+    // channel_count is the number of channels being published; each is streamed as its
+    // own COLOUR_DATA message
     void updateFinalColour(float r, float g, float b,
                          const std::vector<float>& frequencies,
                          const std::vector<float>& magnitudes,
                          uint32_t sample_rate,
-                         uint32_t fft_size);
+                         uint32_t fft_size,
+                         std::chrono::steady_clock::time_point capture_time = {},
+                         uint16_t channel = 0,
+                         uint16_t channel_count = 1);
+    
+    void updateCaptureStats(const AudioProcessor::CaptureStats& stats);
+    void updateSpectralFeatures(const SpectralFeatures& features,
+                                std::chrono::steady_clock::time_point capture_time);
     
     void updateSmoothingConfig(bool enabled, float factor);
     void updateFrequencyRange(uint32_t min_freq, uint32_t max_freq);
@@ -42,6 +53,7 @@ public:
     bool isHighPerformanceMode() const;
     float getAverageFrameTime() const;
     uint64_t getTotalFramesSent() const;
+    LatencyTracker::Snapshot getCaptureLatency() const;
     
     static SynesthesiaAPIIntegration& getInstance();
 
@@ -49,11 +61,17 @@ private:
     std::unique_ptr<API::APIServer> api_server_;
     std::unique_ptr<ColourMapper> colour_mapper_;
     
+    struct ChannelColours {
+        std::vector<API::ColourData> colours;
+        uint32_t sample_rate{44100};
+        uint32_t fft_size{1024};
+        uint64_t timestamp{0};
+    };
+    
     mutable std::mutex data_mutex_;
-    std::vector<API::ColourData> last_colour_data_;
-    uint32_t last_sample_rate_{44100};
-    uint32_t last_fft_size_{1024};
-    uint64_t last_timestamp_{0};
+    std::vector<ChannelColours> last_channels_{1};
+    API::PipelineStats last_stats_{};
+    API::FrameFeatures last_features_{};
     
     bool smoothing_enabled_{true};
     float smoothing_factor_{0.8f};
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+#include "colour_mapper.h"
+#include "fft_processor.h"
+#include "spectral_features.h"
+
+// Everything one analysis pass produced. Published as a unit by AudioProcessor so that
+// readers never combine the peaks of one frame with the spectrum or colour of another.
+struct AnalysisFrame {
+	uint64_t sequence = 0;	// 0 until the first frame has been analysed
+	std::chrono::steady_clock::time_point captureTime{};
+	float sampleRate = 44100.0f;
+	float dominantFrequency = 0.0f;
+	float loudness = 0.0f;
+	SpectralFeatures features;
+	ColourMapper::ColourResult colour{0.1f, 0.1f, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+	std::vector<FFTProcessor::FrequencyPeak> peaks;	 // strongest first
+	std::vector<float> magnitudes;					 // FFT_SIZE / 2 processed bin magnitudes
+	std::vector<float> spectralEnvelope;
+};
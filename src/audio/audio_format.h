@@ -0,0 +1,14 @@
+#pragma once
+
+// Shape of a live stream, settled when it opens. Analysis runs at analysisRate(); anything
+// converting between bins, samples and Hz takes its rate from here, or from the
+// AnalysisFrame the rate produced, never from an assumed 44.1 kHz.
+struct AudioFormat {
+	float captureRate = 44100.0f;  // what the device delivers
+	int decimation = 1;			   // captured samples per analysed sample
+	int channelCount = 1;
+
+	float analysisRate() const { return captureRate / static_cast<float>(decimation); }
+
+	bool operator==(const AudioFormat&) const = default;
+};
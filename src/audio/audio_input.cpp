@@ -1,6 +1,7 @@
 #include "audio_input.h"
 
 #include <algorithm>
+#include <chrono>
 #include <iostream>
 #include <stdexcept>
 
@@ -26,14 +27,9 @@ public:
 
 AudioInput::AudioInput()
 	: stream(nullptr),
-	  sampleRate(44100.0f),
-	  channelCount(1),
 	  activeChannel(0),
-	  noiseGateThreshold(0.0001f),
-	  dcRemovalAlpha(0.995f) {
-	previousInputs.push_back(0.0f);
-	previousOutputs.push_back(0.0f);
-
+	  callbackCount(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_callbacks_total", "PortAudio input callbacks received")) {
 #ifdef __linux__
 	ALSAErrorSuppressor suppressor;
 #endif
@@ -50,6 +46,111 @@ AudioInput::~AudioInput() {
 	Pa_Terminate();
 
 	processor.stop();
+	channelProcessors.clear();
+}
+
+AudioProcessor& AudioInput::channelProcessor(const int channel) {
+	return channel > 0 && static_cast<size_t>(channel) <= channelProcessors.size()
+			   ? *channelProcessors[static_cast<size_t>(channel) - 1]
+			   : processor;
+}
+
+const AudioProcessor& AudioInput::channelProcessor(const int channel) const {
+	return channel > 0 && static_cast<size_t>(channel) <= channelProcessors.size()
+			   ? *channelProcessors[static_cast<size_t>(channel) - 1]
+			   : processor;
+}
+
+AudioProcessor::FrameSnapshot AudioInput::getLatestFrame() const {
+	return channelProcessor(channelProcessors.empty() ? 0 : activeChannel.load()).getLatestFrame();
+}
+
+AudioProcessor::FrameSnapshot AudioInput::getLatestFrame(const int channel) const {
+	return channelProcessor(channel).getLatestFrame();
+}
+
+void AudioInput::setFrameListener(FrameListener listener) {
+	frameListener = std::move(listener);
+	for (int channel = 0; channel < getAnalysedChannelCount(); ++channel) {
+		listenTo(channel);
+	}
+}
+
+void AudioInput::listenTo(const int channel) {
+	if (!frameListener) {
+		channelProcessor(channel).setFrameListener(nullptr);
+		return;
+	}
+	channelProcessor(channel).setFrameListener(
+		[listener = frameListener, channel](const uint64_t sequence) { listener(channel, sequence); });
+}
+
+void AudioInput::setOverflowPolicy(const AudioProcessor::OverflowPolicy policy) {
+	processor.setOverflowPolicy(policy);
+	for (const auto& extra : channelProcessors) {
+		extra->setOverflowPolicy(policy);
+	}
+}
+
+void AudioInput::setHopSize(const size_t samples) {
+	processor.setHopSize(samples);
+	for (const auto& extra : channelProcessors) {
+		extra->setHopSize(samples);
+	}
+}
+
+void AudioInput::setEQGains(const float low, const float mid, const float high) {
+	processor.setEQGains(low, mid, high);
+	for (const auto& extra : channelProcessors) {
+		extra->setEQGains(low, mid, high);
+	}
+}
+
+void AudioInput::setColourSettings(const AudioProcessor::ColourSettings& settings) {
+	processor.setColourSettings(settings);
+	for (const auto& extra : channelProcessors) {
+		extra->setColourSettings(settings);
+	}
+}
+
+// Called with the stream stopped, so the callback never sees the processors change
+void AudioInput::configureChannels() {
+	const size_t extraChannels = multichannel && format.channelCount > 1
+									 ? static_cast<size_t>(format.channelCount) - 1
+									 : 0;
+
+	channelProcessors.resize(std::min(channelProcessors.size(), extraChannels));
+	while (channelProcessors.size() < extraChannels) {
+		auto extra = std::make_unique<AudioProcessor>();
+		extra->setOverflowPolicy(processor.getOverflowPolicy());
+		extra->setHopSize(processor.getHopSize());
+		extra->setColourSettings(processor.getColourSettings());
+		extra->getFFTProcessor().copySettings(processor.getFFTProcessor());
+		extra->start();
+		channelProcessors.push_back(std::move(extra));
+		listenTo(static_cast<int>(channelProcessors.size()));
+	}
+
+	// Longer callbacks are conditioned in chunks of this size
+	channelBuffers.resize(extraChannels + 1);
+	channelOutputs.resize(channelBuffers.size());
+	for (size_t c = 0; c < channelBuffers.size(); ++c) {
+		channelBuffers[c].resize(FFTProcessor::FFT_SIZE);
+		channelOutputs[c] = channelBuffers[c].data();
+	}
+	decimators.resize(channelBuffers.size());
+}
+
+int AudioInput::chooseDecimation(const double captureRate, const int requested) {
+	if (requested > 0) {
+		return std::min(requested, MAX_DECIMATION);
+	}
+
+	int factor = 1;
+	while (factor < MAX_DECIMATION && captureRate / (factor * 2) >= MIN_ANALYSIS_RATE) {
+		factor *= 2;
+	}
+	return factor;
 }
 
 std::vector<AudioInput::DeviceInfo> AudioInput::getInputDevices() {
@@ -88,25 +189,29 @@ bool AudioInput::initStream(const int deviceIndex, const int numChannels) {
 		return false;
 	}
 
-	channelCount = std::min(numChannels, deviceInfo->maxInputChannels);
-	if (channelCount < 1)
-		channelCount = 1;
-
+	format.channelCount = std::max(std::min(numChannels, deviceInfo->maxInputChannels), 1);
 	activeChannel = 0;
 
-	previousInputs.resize(static_cast<size_t>(channelCount), 0.0f);
-	previousOutputs.resize(static_cast<size_t>(channelCount), 0.0f);
+	conditioner.setChannelCount(format.channelCount);
+	configureChannels();
 
 	PaStreamParameters inputParameters{};
 	inputParameters.device = deviceIndex;
-	inputParameters.channelCount = channelCount;
+	inputParameters.channelCount = format.channelCount;
 	inputParameters.sampleFormat = paFloat32;
-	inputParameters.suggestedLatency = deviceInfo->defaultLowInputLatency;
+	inputParameters.suggestedLatency = captureConfig.suggestedLatency > 0.0
+										   ? captureConfig.suggestedLatency
+										   : deviceInfo->defaultLowInputLatency;
 	inputParameters.hostApiSpecificStreamInfo = nullptr;
 
-	const PaError err =
-		Pa_OpenStream(&stream, &inputParameters, nullptr, deviceInfo->defaultSampleRate,
-					  FFTProcessor::FFT_SIZE, paClipOff, audioCallback, this);
+	const double streamSampleRate =
+		captureConfig.sampleRate > 0.0 ? captureConfig.sampleRate : deviceInfo->defaultSampleRate;
+	const auto framesPerBuffer = captureConfig.framesPerBuffer > 0
+									 ? static_cast<unsigned long>(captureConfig.framesPerBuffer)
+									 : paFramesPerBufferUnspecified;
+
+	const PaError err = Pa_OpenStream(&stream, &inputParameters, nullptr, streamSampleRate,
+									  framesPerBuffer, paClipOff, audioCallback, this);
 
 	if (err != paNoError) {
 		std::cerr << "Failed to open audio stream: " << Pa_GetErrorText(err) << "\n";
@@ -114,8 +219,14 @@ bool AudioInput::initStream(const int deviceIndex, const int numChannels) {
 		return false;
 	}
 
+	format.captureRate = static_cast<float>(streamSampleRate);
 	if (const PaStreamInfo* streamInfo = Pa_GetStreamInfo(stream)) {
-		sampleRate = static_cast<float>(streamInfo->sampleRate);
+		format.captureRate = static_cast<float>(streamInfo->sampleRate);
+	}
+	format.decimation = chooseDecimation(format.captureRate, captureConfig.decimation);
+	for (auto& decimator : decimators) {
+		decimator.configure(format.decimation, static_cast<double>(format.captureRate),
+							channelBuffers.front().size());
 	}
 
 	if (const PaError startErr = Pa_StartStream(stream); startErr != paNoError) {
@@ -127,13 +238,23 @@ bool AudioInput::initStream(const int deviceIndex, const int numChannels) {
 	return true;
 }
 
-void AudioInput::getColourForCurrentFrequency(float& r, float& g, float& b, float& freq,
-											  float& wavelength) const {
-	processor.getColourForCurrentFrequency(r, g, b, freq, wavelength);
-}
+AudioProcessor::Clock::time_point AudioInput::captureTimeFromStreamTime(
+	const PaStreamCallbackTimeInfo* timeInfo) {
+	const auto now = AudioProcessor::Clock::now();
+	if (!timeInfo || timeInfo->inputBufferAdcTime <= 0.0) {
+		return now;
+	}
 
-std::vector<FFTProcessor::FrequencyPeak> AudioInput::getFrequencyPeaks() const {
-	return processor.getFrequencyPeaks();
+	// PortAudio stream time has an unspecified epoch, so translate the ADC time into
+	// steady_clock by its age relative to the callback's own stream time. Some host APIs
+	// report nonsense here, so anything outside a sane window falls back to "now".
+	const double age = timeInfo->currentTime - timeInfo->inputBufferAdcTime;
+	if (age < 0.0 || age > 1.0) {
+		return now;
+	}
+
+	return now - std::chrono::duration_cast<AudioProcessor::Clock::duration>(
+					 std::chrono::duration<double>(age));
 }
 
 void AudioInput::stopStream() {
@@ -145,45 +266,65 @@ void AudioInput::stopStream() {
 }
 
 int AudioInput::audioCallback(const void* input, void* /* output */, const unsigned long frameCount,
-							  const PaStreamCallbackTimeInfo* /* timeInfo */,
-							  PaStreamCallbackFlags /* statusFlags */, void* userData) {
+							  const PaStreamCallbackTimeInfo* timeInfo,
+							  const PaStreamCallbackFlags statusFlags, void* userData) {
 	auto* audio = static_cast<AudioInput*>(userData);
 
+	audio->callbackCount.increment();
+
+	const auto captureTime = captureTimeFromStreamTime(timeInfo);
+	if (statusFlags & paInputOverflow) {
+		audio->processor.reportInputOverflow(captureTime);
+		for (const auto& extra : audio->channelProcessors) {
+			extra->reportInputOverflow(captureTime);
+		}
+	}
+	if (statusFlags & paInputUnderflow) {
+		audio->processor.reportInputUnderflow(captureTime);
+		for (const auto& extra : audio->channelProcessors) {
+			extra->reportInputUnderflow(captureTime);
+		}
+	}
+
 	if (!input) {
 		return paContinue;
 	}
 
 	try {
 		const auto* inBuffer = static_cast<const float*>(input);
-		thread_local std::vector<float> processedBuffer;
-		if (processedBuffer.size() < frameCount) {
-			processedBuffer.resize(frameCount);
-		}
 
+		// Mono analysis conditions the active channel into channelBuffers[0]
 		int activeChannel = audio->activeChannel.load();
-		const int channelCount = audio->channelCount;
-
+		const int channelCount = audio->format.channelCount;
+		const float analysisRate = audio->format.analysisRate();
 		if (activeChannel >= channelCount) {
 			activeChannel = 0;
 		}
 
-		for (unsigned long i = 0; i < frameCount; ++i) {
-			const auto activeChannelIndex = static_cast<size_t>(activeChannel);
-			const float sample = inBuffer[i * static_cast<unsigned long>(channelCount) + activeChannelIndex];
-
-			float filteredSample = sample - audio->previousInputs[activeChannelIndex] +
-								   audio->dcRemovalAlpha * audio->previousOutputs[activeChannelIndex];
-			audio->previousInputs[activeChannelIndex] = sample;
-			audio->previousOutputs[activeChannelIndex] = filteredSample;
-
-			if (std::abs(filteredSample) < audio->noiseGateThreshold) {
-				filteredSample = 0.0f;
+		const bool multichannel = !audio->channelProcessors.empty();
+		const size_t capacity = audio->channelBuffers.front().size();
+		const double captureRate = audio->format.captureRate;
+		for (size_t offset = 0; offset < frameCount; offset += capacity) {
+			const size_t frames = std::min<size_t>(capacity, frameCount - offset);
+			const float* block = inBuffer + offset * static_cast<size_t>(channelCount);
+			// Later chunks of a long buffer were captured later than its first frame
+			const std::chrono::duration<double> chunkOffset(static_cast<double>(offset) / captureRate);
+			const auto chunkTime =
+				captureTime + std::chrono::duration_cast<AudioProcessor::Clock::duration>(chunkOffset);
+
+			if (multichannel) {
+				audio->conditioner.processAll(block, frames, channelCount, audio->channelOutputs);
+			} else {
+				audio->conditioner.process(block, frames, channelCount, activeChannel,
+										   audio->channelOutputs.front());
 			}
 
-			processedBuffer[i] = filteredSample;
+			for (size_t c = 0; c < audio->channelOutputs.size(); ++c) {
+				const size_t samples = audio->decimators[c].process(audio->channelOutputs[c], frames);
+				audio->channelProcessor(static_cast<int>(c))
+					.queueAudioData(audio->channelOutputs[c], samples, analysisRate, chunkTime);
+			}
 		}
-
-		audio->processor.queueAudioData(processedBuffer.data(), frameCount, audio->sampleRate);
 	}
 
 	catch (const std::exception& ex) {
@@ -3,10 +3,17 @@
 #include <portaudio.h>
 
 #include <atomic>
+#include <functional>
+#include <memory>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "audio_format.h"
 #include "audio_processor.h"
+#include "decimator.h"
+#include "metrics.h"
+#include "signal_conditioner.h"
 
 class AudioInput {
 public:
@@ -16,44 +23,110 @@ public:
 		int maxChannels;
 	};
 
+	// Stream parameters, applied from the next initStream. Zero leaves a value to the
+	// device: its default sample rate and low input latency, or, for framesPerBuffer,
+	// whatever block size suits the host API best.
+	struct CaptureConfig {
+		int framesPerBuffer = FFTProcessor::FFT_SIZE;
+		double suggestedLatency = 0.0;	// seconds
+		double sampleRate = 0.0;
+		// Captured samples per analysed sample, at most MAX_DECIMATION. 0 picks the
+		// largest power of two that keeps analysis at MIN_ANALYSIS_RATE or above, so
+		// 96 and 192 kHz streams cost the same to analyse as 48 kHz.
+		int decimation = 1;
+
+		bool operator==(const CaptureConfig&) const = default;
+	};
+
+	static constexpr int MAX_DECIMATION = 8;
+	static constexpr double MIN_ANALYSIS_RATE = 44100.0;
+
 	AudioInput();
 	~AudioInput();
 
 	static std::vector<DeviceInfo> getInputDevices();
 	bool initStream(int deviceIndex, int numChannels = 1);
-	void getColourForCurrentFrequency(float& r, float& g, float& b, float& freq,
-									  float& wavelength) const;
-	std::vector<FFTProcessor::FrequencyPeak> getFrequencyPeaks() const;
 	FFTProcessor& getFFTProcessor() { return processor.getFFTProcessor(); }
+	// The active channel's frame. In multichannel mode that channel has its own processor;
+	// otherwise it is the only channel analysed.
+	AudioProcessor::FrameSnapshot getLatestFrame() const;
+	AudioProcessor::FrameSnapshot getLatestFrame(int channel) const;
+	uint64_t getFrameSequence() const { return processor.getFrameSequence(); }
+	// Called on a channel's worker each time it publishes a frame, with the channel and the
+	// frame's sequence number. In multichannel mode every channel reports, each from its own
+	// thread. Keep it short, as for AudioProcessor::FrameListener.
+	using FrameListener = std::function<void(int channel, uint64_t sequence)>;
+	void setFrameListener(FrameListener listener);
+	AudioProcessor::LatencyStats getLatencyStats() const { return processor.getLatencyStats(); }
+	AudioProcessor::CaptureStats getCaptureStats() const { return processor.getCaptureStats(); }
+	void setOverflowPolicy(AudioProcessor::OverflowPolicy policy);
+	void setCaptureConfig(const CaptureConfig& config) { captureConfig = config; }
+	const CaptureConfig& getCaptureConfig() const { return captureConfig; }
+	// See AudioProcessor::setHopSize; small capture buffers only cut latency when paired
+	// with a hop to match
+	void setHopSize(size_t samples);
+	size_t getHopSize() const { return processor.getHopSize(); }
+	// The open stream's format; frames carry the analysis rate they were made at
+	const AudioFormat& getFormat() const { return format; }
 
 	void setNoiseGateThreshold(const float threshold) {
-		noiseGateThreshold = threshold;
-		processor.setNoiseGateThreshold(threshold);
+		conditioner.setNoiseGateThreshold(threshold);
 	}
-	void setDcRemovalAlpha(const float alpha) { dcRemovalAlpha = alpha; }
-	void setEQGains(const float low, const float mid, const float high) {
-		processor.setEQGains(low, mid, high);
+	void setDcRemovalAlpha(const float alpha) { conditioner.setDcRemovalAlpha(alpha); }
+	void setEQGains(float low, float mid, float high);
+	void setColourSettings(const AudioProcessor::ColourSettings& settings);
+	AudioProcessor::ColourSettings getColourSettings() const {
+		return processor.getColourSettings();
 	}
 
-	int getChannelCount() const { return channelCount; }
+	int getChannelCount() const { return format.channelCount; }
 	int getActiveChannel() const { return activeChannel.load(); }
 	void setActiveChannel(const int channel) {
-		activeChannel.store(channel >= 0 && channel < channelCount ? channel : 0);
+		activeChannel.store(channel >= 0 && channel < format.channelCount ? channel : 0);
+	}
+
+	// Analyse every channel of the stream at once instead of only the active one. Each
+	// channel beyond the first gets its own AudioProcessor, and with it its own worker
+	// thread, taking its FFT and colour settings from the first. Takes effect from the
+	// next initStream, which must not run while another thread reads channel frames.
+	void setMultichannel(const bool enabled) { multichannel = enabled; }
+	bool isMultichannel() const { return multichannel; }
+	// Channels with their own analysis: the stream's channel count in multichannel mode,
+	// otherwise 1
+	int getAnalysedChannelCount() const {
+		return static_cast<int>(channelProcessors.size()) + 1;
 	}
 
 private:
 	PaStream* stream;
 	AudioProcessor processor;
-	float sampleRate;
-	int channelCount;
+	AudioFormat format;
 	std::atomic<int> activeChannel;
+	CaptureConfig captureConfig;
+
+	// Multichannel mode: processor analyses channel 0 and channelProcessors[c - 1]
+	// channel c. Each callback deinterleaves into channelBuffers in one pass; in mono
+	// mode channelBuffers holds just the conditioned active channel. Allocated with the
+	// stream so the callback never allocates.
+	bool multichannel = false;
+	std::vector<std::unique_ptr<AudioProcessor>> channelProcessors;
+	std::vector<std::vector<float>> channelBuffers;
+	std::vector<float*> channelOutputs;
+	std::vector<Decimator> decimators;	// one per entry of channelBuffers
+	FrameListener frameListener;
+
+	SignalConditioner conditioner;
 
-	std::vector<float> previousInputs;
-	std::vector<float> previousOutputs;
-	float noiseGateThreshold;
-	float dcRemovalAlpha;
+	Metrics::Counter& callbackCount;
 
 	void stopStream();
+	AudioProcessor& channelProcessor(int channel);
+	const AudioProcessor& channelProcessor(int channel) const;
+	void configureChannels();
+	void listenTo(int channel);
+	static int chooseDecimation(double captureRate, int requested);
+	static AudioProcessor::Clock::time_point captureTimeFromStreamTime(
+		const PaStreamCallbackTimeInfo* timeInfo);
 	static int audioCallback(const void* input, void* output, unsigned long frameCount,
 							 const PaStreamCallbackTimeInfo* timeInfo,
 							 PaStreamCallbackFlags statusFlags, void* userData);
@@ -2,12 +2,53 @@
 
 #include <algorithm>
 
+namespace {
+
+// Sizes a frame's vectors for the largest analysis result so filling it never allocates
+void reserveFrame(AnalysisFrame& frame) {
+	frame.peaks.reserve(FFTProcessor::MAX_PEAKS);
+	frame.magnitudes.reserve(FFTProcessor::FFT_SIZE / 2 + 1);
+	frame.spectralEnvelope.reserve(FFTProcessor::FFT_SIZE / 2 + 1);
+}
+
+}
+
 AudioProcessor::AudioProcessor()
 	: writeIndex(0),
 	  readIndex(0),
 	  running(false),
-	  currentColour{0.1f, 0.1f, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f},
-	  currentDominantFrequency(0.0f) {}
+	  droppedBuffers(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_dropped_buffers_total",
+		  "Capture buffers discarded because the analysis queue was full")),
+	  mergedBuffers(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_merged_buffers_total",
+		  "Capture buffers coalesced because the analysis queue was full")),
+	  truncatedSamples(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_truncated_samples_total",
+		  "Samples cut from capture buffers larger than the queue slot")),
+	  inputOverflows(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_input_overflows_total",
+		  "Callbacks flagged with an input overflow (samples lost before we saw them)")),
+	  inputUnderflows(Metrics::Registry::instance().counter(
+		  "synesthesia_audio_input_underflows_total", "Callbacks flagged with an input underflow")),
+	  processedFrames(Metrics::Registry::instance().counter(
+		  "synesthesia_analysis_frames_total", "Buffers analysed by the worker thread")),
+	  unpublishedFrames(Metrics::Registry::instance().counter(
+		  "synesthesia_analysis_unpublished_frames_total",
+		  "Analysed frames not published because readers had every spare slot pinned")),
+	  peaksPerFrame(Metrics::Registry::instance().histogram(
+		  "synesthesia_analysis_peaks_per_frame", "Frequency peaks detected per analysed buffer",
+		  {0, 1, 2, 4, 8, 16, 32, 64, 100})),
+	  pipelineLatency(Metrics::Registry::instance().histogram(
+		  "synesthesia_pipeline_latency_seconds",
+		  "Time from ADC capture to the analysis result being published",
+		  Metrics::latencyBucketsSeconds())),
+	  analysisWindow(FFTProcessor::FFT_SIZE, 0.0f) {
+	frames.initialiseSlots(reserveFrame);
+	reserveFrame(unpublishedFrame);
+	tempFreqs.reserve(FFTProcessor::MAX_PEAKS);
+	tempMags.reserve(FFTProcessor::MAX_PEAKS);
+}
 
 AudioProcessor::~AudioProcessor() { stop(); }
 
@@ -16,6 +57,10 @@ void AudioProcessor::start() {
 		return;
 	writeIndex = 0;
 	readIndex = 0;
+	skipOldest = false;
+	pendingMerge.sampleCount = 0;
+	windowNewSamples = 0;
+	windowSampleRate = 0.0f;
 
 	workerThread = std::thread(&AudioProcessor::processingThreadFunc, this);
 }
@@ -34,29 +79,108 @@ void AudioProcessor::stop() {
 }
 
 void AudioProcessor::queueAudioData(const float* buffer, const size_t numSamples,
-									const float sampleRate) {
+									const float sampleRate, const Clock::time_point captureTime) {
 	if (!buffer || numSamples == 0 || !running)
 		return;
 
-	const size_t currentWrite = writeIndex.load(std::memory_order_relaxed);
-	const size_t nextWrite = (currentWrite + 1) % QUEUE_SIZE;
+	size_t sampleCount = numSamples;
+	if (sampleCount > MAX_SAMPLES) {
+		truncatedSampleEvents.record(sampleCount - MAX_SAMPLES, captureTime);
+		truncatedSamples.increment(sampleCount - MAX_SAMPLES);
+		sampleCount = MAX_SAMPLES;
+	}
 
-	if (nextWrite == readIndex.load(std::memory_order_relaxed)) {
-		return;
+	const OverflowPolicy policy = overflowPolicy.load(std::memory_order_relaxed);
+	size_t nextWrite = (writeIndex.load(std::memory_order_relaxed) + 1) % QUEUE_SIZE;
+
+	// A buffer held back under DropOldest goes out first, as soon as the worker frees a slot
+	if (policy == OverflowPolicy::DropOldest && pendingMerge.sampleCount > 0 &&
+		nextWrite != readIndex.load(std::memory_order_acquire)) {
+		enqueue(pendingMerge.data.data(), pendingMerge.sampleCount, pendingMerge.sampleRate,
+				pendingMerge.captureTime);
+		pendingMerge.sampleCount = 0;
+		nextWrite = (nextWrite + 1) % QUEUE_SIZE;
 	}
 
-	AudioBuffer& queuedBuffer = audioQueue[currentWrite];
-	queuedBuffer.sampleRate = sampleRate;
-	queuedBuffer.sampleCount = std::min(numSamples, MAX_SAMPLES);
-	std::copy_n(buffer, queuedBuffer.sampleCount, queuedBuffer.data.begin());
+	if (nextWrite == readIndex.load(std::memory_order_acquire)) {
+		switch (policy) {
+			case OverflowPolicy::DropNewest:
+				droppedBufferEvents.record(1, captureTime);
+				droppedBuffers.increment();
+				return;
+
+			case OverflowPolicy::DropOldest:
+				// The worker may be reading any queued slot, so it drops the oldest itself
+				// while this buffer waits, replacing any held back before it
+				if (pendingMerge.sampleCount > 0) {
+					droppedBufferEvents.record(1, pendingMerge.captureTime);
+					droppedBuffers.increment();
+				}
+				pendingMerge.sampleRate = sampleRate;
+				pendingMerge.captureTime = captureTime;
+				pendingMerge.sampleCount = sampleCount;
+				std::copy_n(buffer, sampleCount, pendingMerge.data.begin());
+				skipOldest.store(true, std::memory_order_relaxed);
+				break;
+
+			case OverflowPolicy::Merge:
+				appendToPending(buffer, sampleCount, sampleRate, captureTime);
+				mergedBufferEvents.record(1, captureTime);
+				mergedBuffers.increment();
+				return;
+		}
+	} else if (pendingMerge.sampleCount > 0) {
+		appendToPending(buffer, sampleCount, sampleRate, captureTime);
+		enqueue(pendingMerge.data.data(), pendingMerge.sampleCount, pendingMerge.sampleRate,
+				pendingMerge.captureTime);
+		pendingMerge.sampleCount = 0;
+	} else {
+		enqueue(buffer, sampleCount, sampleRate, captureTime);
+	}
 
-	writeIndex.store(nextWrite, std::memory_order_release);
 	{
 		std::lock_guard lock(queueMutex);
 		dataAvailable.notify_one();
 	}
 }
 
+void AudioProcessor::enqueue(const float* buffer, const size_t sampleCount,
+							 const float sampleRate, const Clock::time_point captureTime) {
+	const size_t currentWrite = writeIndex.load(std::memory_order_relaxed);
+	AudioBuffer& queuedBuffer = audioQueue[currentWrite];
+	queuedBuffer.sampleRate = sampleRate;
+	queuedBuffer.captureTime = captureTime;
+	queuedBuffer.sampleCount = sampleCount;
+	std::copy_n(buffer, sampleCount, queuedBuffer.data.begin());
+	writeIndex.store((currentWrite + 1) % QUEUE_SIZE, std::memory_order_release);
+}
+
+void AudioProcessor::appendToPending(const float* buffer, const size_t numSamples,
+									 const float sampleRate, const Clock::time_point captureTime) {
+	if (pendingMerge.sampleCount == 0) {
+		pendingMerge.sampleRate = sampleRate;
+		pendingMerge.captureTime = captureTime;
+	}
+
+	// numSamples <= MAX_SAMPLES, so the overflow never exceeds what is already pending
+	if (const size_t total = pendingMerge.sampleCount + numSamples; total > MAX_SAMPLES) {
+		const size_t overflow = total - MAX_SAMPLES;
+		std::copy(pendingMerge.data.begin() + static_cast<std::ptrdiff_t>(overflow),
+				  pendingMerge.data.begin() + static_cast<std::ptrdiff_t>(pendingMerge.sampleCount),
+				  pendingMerge.data.begin());
+		pendingMerge.sampleCount -= overflow;
+		pendingMerge.captureTime += std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(static_cast<double>(overflow) /
+										  static_cast<double>(pendingMerge.sampleRate)));
+		truncatedSampleEvents.record(overflow, captureTime);
+		truncatedSamples.increment(overflow);
+	}
+
+	std::copy_n(buffer, numSamples,
+				pendingMerge.data.begin() + static_cast<std::ptrdiff_t>(pendingMerge.sampleCount));
+	pendingMerge.sampleCount += numSamples;
+}
+
 void AudioProcessor::processingThreadFunc() {
 	while (running) {
 		std::unique_lock lock(queueMutex);
@@ -71,28 +195,89 @@ void AudioProcessor::processingThreadFunc() {
 		lock.unlock();
 
 		while (running) {
-			const size_t currentRead = readIndex.load(std::memory_order_relaxed);
-			if (currentRead == writeIndex.load(std::memory_order_relaxed)) {
+			size_t currentRead = readIndex.load(std::memory_order_relaxed);
+			const size_t currentWrite = writeIndex.load(std::memory_order_acquire);
+			if (currentRead == currentWrite) {
 				break;
 			}
 
-			processBuffer(audioQueue[currentRead]);
+			// Under DropOldest the producer asks for the oldest buffer to be skipped, to make
+			// room for the one it is holding back
+			if (skipOldest.exchange(false, std::memory_order_relaxed) &&
+				(currentRead + 1) % QUEUE_SIZE != currentWrite) {
+				droppedBufferEvents.record(1, audioQueue[currentRead].captureTime);
+				droppedBuffers.increment();
+				currentRead = (currentRead + 1) % QUEUE_SIZE;
+			}
+
+			// The slot stays ours until readIndex moves past it
+			const AudioBuffer& slot = audioQueue[currentRead];
+			processingBuffer.sampleRate = slot.sampleRate;
+			processingBuffer.captureTime = slot.captureTime;
+			processingBuffer.sampleCount = std::min(slot.sampleCount, MAX_SAMPLES);
+			std::copy_n(slot.data.begin(), processingBuffer.sampleCount,
+						processingBuffer.data.begin());
 			readIndex.store((currentRead + 1) % QUEUE_SIZE, std::memory_order_release);
+
+			accumulate(processingBuffer);
+
+			// Analyse once the hop is reached and nothing newer is waiting, or the window
+			// has been entirely replaced
+			const bool drained = readIndex.load(std::memory_order_acquire) ==
+								 writeIndex.load(std::memory_order_acquire);
+			if (windowNewSamples >= analysisWindow.size() ||
+				(drained && windowNewSamples >= hopSize.load(std::memory_order_relaxed))) {
+				processBuffer(analysisWindow, windowNewSamples, windowSampleRate,
+							  windowCaptureTime);
+				windowNewSamples = 0;
+			}
 		}
 	}
 }
 
-void AudioProcessor::processBuffer(const AudioBuffer& buffer) {
-	fftProcessor.processBuffer(std::span(buffer.data.data(), buffer.sampleCount),
-							   buffer.sampleRate);
-	zeroCrossingDetector.processSamples(buffer.data.data(), buffer.sampleCount);
+void AudioProcessor::accumulate(const AudioBuffer& buffer) {
+	if (buffer.sampleRate != windowSampleRate) {
+		std::ranges::fill(analysisWindow, 0.0f);
+		windowNewSamples = 0;
+		windowSampleRate = buffer.sampleRate;
+	}
+
+	const size_t count = std::min(buffer.sampleCount, analysisWindow.size());
+	std::shift_left(analysisWindow.begin(), analysisWindow.end(),
+					static_cast<std::ptrdiff_t>(count));
+	std::copy_n(buffer.data.begin() + static_cast<std::ptrdiff_t>(buffer.sampleCount - count),
+				count, analysisWindow.end() - static_cast<std::ptrdiff_t>(count));
+	windowNewSamples += buffer.sampleCount;
+	windowCaptureTime = buffer.captureTime;
+}
+
+void AudioProcessor::processBuffer(const std::span<const float> samples, const size_t newSamples,
+								   const float sampleRate, const Clock::time_point captureTime,
+								   const bool live) {
+	const auto startTime = Clock::now();
+	if (live) {
+		queueLatency.record(startTime - captureTime);
+	}
 
-	tempPeaks = fftProcessor.getDominantFrequencies();
+	fftProcessor.processWindow(samples, newSamples, sampleRate, captureTime);
+	const auto fresh = samples.last(std::min(newSamples, samples.size()));
+	zeroCrossingDetector.setSampleRate(sampleRate);
+	zeroCrossingDetector.processSamples(fresh.data(), fresh.size());
+
+	AnalysisFrame* frame = frames.beginWrite();
+	const bool publishable = frame != nullptr;
+	if (!publishable) {
+		frame = &unpublishedFrame;
+	}
+
+	fftProcessor.copyResults(frame->peaks, frame->magnitudes, frame->spectralEnvelope,
+							 frame->loudness, frame->features);
+	auto& peaks = frame->peaks;
 
 	if (const float zcFreq = zeroCrossingDetector.getEstimatedFrequency();
 		zcFreq > 20.0f && zcFreq < 20000.0f) {
 		bool foundMatch = false;
-		for (auto& peak : tempPeaks) {
+		for (auto& peak : peaks) {
 			if (const float freqRatio = peak.frequency / zcFreq;
 				freqRatio > 0.95f && freqRatio < 1.05f) {
 				peak.frequency = zcFreq;
@@ -101,66 +286,145 @@ void AudioProcessor::processBuffer(const AudioBuffer& buffer) {
 			}
 		}
 
-		if (!foundMatch && tempPeaks.size() < FFTProcessor::MAX_PEAKS) {
+		if (!foundMatch && peaks.size() < FFTProcessor::MAX_PEAKS) {
 			const float zcDensity = zeroCrossingDetector.getZeroCrossingDensity();
 			const float estimatedMagnitude = std::min(1.0f, zcDensity / 1000.0f);
 
-			tempPeaks.push_back({zcFreq, estimatedMagnitude});
+			peaks.push_back({zcFreq, estimatedMagnitude});
 
-			std::ranges::sort(tempPeaks, [](const FFTProcessor::FrequencyPeak& a,
+			std::ranges::sort(peaks, [](const FFTProcessor::FrequencyPeak& a,
 										const FFTProcessor::FrequencyPeak& b) {
 				return a.magnitude > b.magnitude;
 			});
 
-			if (tempPeaks.size() > FFTProcessor::MAX_PEAKS) {
-				tempPeaks.resize(FFTProcessor::MAX_PEAKS);
+			if (peaks.size() > FFTProcessor::MAX_PEAKS) {
+				peaks.resize(FFTProcessor::MAX_PEAKS);
 			}
 		}
 	}
 
+	const auto analysisTime = Clock::now();
+	analysisLatency.record(analysisTime - startTime);
+
 	tempFreqs.clear();
 	tempMags.clear();
-	tempFreqs.reserve(tempPeaks.size());
-	tempMags.reserve(tempPeaks.size());
-	
-	for (const auto& peak : tempPeaks) {
+	for (const auto& peak : peaks) {
 		tempFreqs.push_back(peak.frequency);
 		tempMags.push_back(peak.magnitude);
 	}
 
-	{
-		std::lock_guard lock(resultsMutex);
-		currentPeaks = std::move(tempPeaks);
-		currentColour = ColourMapper::frequenciesToColour(tempFreqs, tempMags, {}, 44100.0f, 1.0f, true);
-		currentDominantFrequency = !currentPeaks.empty() ? currentPeaks[0].frequency : 0.0f;
+	const ColourSettings settings = getColourSettings();
+	static const std::vector<float> noEnvelope;
+	frame->colour = ColourMapper::frequenciesToColour(
+		tempFreqs, tempMags, settings.blendEnvelope ? frame->spectralEnvelope : noEnvelope,
+		sampleRate, settings.gamma, settings.useP3);
+	const auto colourTime = Clock::now();
+	colourLatency.record(colourTime - analysisTime);
+
+	const size_t peakCount = peaks.size();
+	const uint64_t sequence = frameSequence.load(std::memory_order_relaxed) + 1;
+	frame->sequence = sequence;
+	frame->captureTime = captureTime;
+	frame->sampleRate = sampleRate;
+	frame->dominantFrequency = !peaks.empty() ? peaks[0].frequency : 0.0f;
+
+	if (publishable) {
+		frames.publish();
+	} else {
+		unpublishedFrames.increment();
+	}
+	frameSequence.store(sequence, std::memory_order_release);
+
+	processedFrames.increment();
+	peaksPerFrame.observe(static_cast<double>(peakCount));
+
+	if (live) {
+		const auto totalTime = Clock::now() - captureTime;
+		totalLatency.record(totalTime);
+		pipelineLatency.observe(std::chrono::duration<double>(totalTime).count());
+	}
+
+	std::lock_guard lock(frameListenerMutex);
+	if (frameListener) {
+		frameListener(sequence);
 	}
 }
 
-std::vector<FFTProcessor::FrequencyPeak> AudioProcessor::getFrequencyPeaks() const {
-	std::lock_guard lock(resultsMutex);
-	return currentPeaks;
+void AudioProcessor::analyse(const float* buffer, const size_t numSamples, const float sampleRate,
+							 const Clock::time_point frameTime) {
+	if (!buffer || numSamples == 0 || running)
+		return;
+
+	const size_t sampleCount = std::min(numSamples, MAX_SAMPLES);
+	processBuffer(std::span(buffer, sampleCount), sampleCount, sampleRate, frameTime, false);
 }
 
-void AudioProcessor::getColourForCurrentFrequency(float& r, float& g, float& b, float& freq,
-												  float& wavelength) const {
-	std::lock_guard lock(resultsMutex);
-	r = currentColour.r;
-	g = currentColour.g;
-	b = currentColour.b;
-	freq = currentDominantFrequency;
-	wavelength = currentColour.dominantWavelength;
+void AudioProcessor::setFrameListener(FrameListener listener) {
+	std::lock_guard lock(frameListenerMutex);
+	frameListener = std::move(listener);
+}
+
+AudioProcessor::LatencyStats AudioProcessor::getLatencyStats() const {
+	return {queueLatency.snapshot(), analysisLatency.snapshot(), colourLatency.snapshot(),
+			totalLatency.snapshot()};
+}
+
+AudioProcessor::CaptureStats AudioProcessor::getCaptureStats() const {
+	return {droppedBufferEvents.snapshot(), mergedBufferEvents.snapshot(),
+			truncatedSampleEvents.snapshot(), inputOverflowEvents.snapshot(),
+			inputUnderflowEvents.snapshot(), overflowPolicy.load()};
+}
+
+void AudioProcessor::reportInputOverflow(const Clock::time_point when) {
+	inputOverflowEvents.record(1, when);
+	inputOverflows.increment();
+}
+
+void AudioProcessor::reportInputUnderflow(const Clock::time_point when) {
+	inputUnderflowEvents.record(1, when);
+	inputUnderflows.increment();
+}
+
+void AudioProcessor::setHopSize(const size_t samples) {
+	hopSize.store(std::clamp(samples, MIN_HOP_SIZE, static_cast<size_t>(FFTProcessor::FFT_SIZE)));
 }
 
 void AudioProcessor::setEQGains(const float low, const float mid, const float high) {
 	fftProcessor.setEQGains(low, mid, high);
 }
 
+void AudioProcessor::setColourSettings(const ColourSettings& settings) {
+	std::lock_guard lock(colourSettingsMutex);
+	colourSettings = settings;
+}
+
+AudioProcessor::ColourSettings AudioProcessor::getColourSettings() const {
+	std::lock_guard lock(colourSettingsMutex);
+	return colourSettings;
+}
+
 void AudioProcessor::reset() {
 	fftProcessor.reset();
 	zeroCrossingDetector.reset();
 
-	std::lock_guard lock(resultsMutex);
-	currentColour = {0.1f, 0.1f, 0.1f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
-	currentDominantFrequency = 0.0f;
-	currentPeaks.clear();
+	// The worker is the only writer while it runs; otherwise this thread may publish
+	if (!running) {
+		if (AnalysisFrame* frame = frames.beginWrite()) {
+			*frame = AnalysisFrame{};
+			reserveFrame(*frame);
+			frames.publish();
+		}
+		frameSequence.store(0, std::memory_order_release);
+	}
+
+	queueLatency.reset();
+	analysisLatency.reset();
+	colourLatency.reset();
+	totalLatency.reset();
+
+	droppedBufferEvents.reset();
+	mergedBufferEvents.reset();
+	truncatedSampleEvents.reset();
+	inputOverflowEvents.reset();
+	inputUnderflowEvents.reset();
 }
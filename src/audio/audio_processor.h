@@ -1,27 +1,100 @@
 #pragma once
 
 #include <atomic>
+#include <chrono>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <thread>
 #include <vector>
 
+#include "analysis_frame.h"
 #include "colour_mapper.h"
+#include "event_counter.h"
 #include "fft_processor.h"
+#include "latency_tracker.h"
+#include "metrics.h"
+#include "snapshot_exchange.h"
 #include "zero_crossing.h"
 
 class AudioProcessor {
 public:
+	using Clock = std::chrono::steady_clock;
+	using FrameSnapshot = SnapshotExchange<AnalysisFrame>::Snapshot;
+
+	// Per-stage latency of the most recent analysis frames, measured from the
+	// moment the first sample of the buffer hit the ADC.
+	struct LatencyStats {
+		LatencyTracker::Snapshot queue;		// capture -> worker pick-up
+		LatencyTracker::Snapshot analysis;	// FFT and peak detection
+		LatencyTracker::Snapshot colour;	// colour mapping
+		LatencyTracker::Snapshot total;		// capture -> result published
+	};
+
+	// What happens to a capture buffer that arrives while the analysis queue is full
+	enum class OverflowPolicy {
+		DropNewest,	 // discard the incoming buffer (lowest overhead)
+		DropOldest,	 // discard the oldest queued buffer so analysis stays current
+		Merge		 // coalesce into one pending buffer, keeping the newest MAX_SAMPLES
+	};
+
+	// Called on the worker thread each time a new analysis result is published, with that
+	// frame's sequence number. Keep it short (e.g. wake another thread); it delays the
+	// next frame.
+	using FrameListener = std::function<void(uint64_t sequence)>;
+
+	// How the worker maps each frame's peaks to its published colour
+	struct ColourSettings {
+		float gamma = 1.0f;
+		bool useP3 = true;
+		bool blendEnvelope = true;	 // mix in the spectral envelope as well as the peaks
+
+		bool operator==(const ColourSettings&) const = default;
+	};
+
+	// Audio lost or reshaped between the capture callback and the analysis worker
+	struct CaptureStats {
+		EventCounter::Snapshot droppedBuffers;	  // whole buffers discarded on a full queue
+		EventCounter::Snapshot mergedBuffers;	  // buffers coalesced under OverflowPolicy::Merge
+		EventCounter::Snapshot truncatedSamples;  // samples cut to fit a queue slot
+		EventCounter::Snapshot inputOverflows;	  // driver reported lost input
+		EventCounter::Snapshot inputUnderflows;
+		OverflowPolicy policy;
+	};
+
 	AudioProcessor();
 	~AudioProcessor();
 
-	void queueAudioData(const float* buffer, size_t numSamples, float sampleRate);
+	void queueAudioData(const float* buffer, size_t numSamples, float sampleRate,
+						Clock::time_point captureTime = Clock::now());
+
+	// Runs one buffer through the pipeline on the calling thread, for offline analysis.
+	// Ignored while the worker is running. frameTime is the buffer's position on the
+	// file's own timeline; capture-relative latency is not recorded.
+	void analyse(const float* buffer, size_t numSamples, float sampleRate,
+				 Clock::time_point frameTime);
 
-	std::vector<FFTProcessor::FrequencyPeak> getFrequencyPeaks() const;
-	void getColourForCurrentFrequency(float& r, float& g, float& b, float& freq,
-									  float& wavelength) const;
+	// The most recently published frame. Never blocks; hold the snapshot only as long as
+	// the data is needed, since a pinned frame cannot be reused by the worker.
+	FrameSnapshot getLatestFrame() const { return frames.read(); }
+	uint64_t getFrameSequence() const { return frameSequence.load(std::memory_order_acquire); }
+	void setFrameListener(FrameListener listener);
+	LatencyStats getLatencyStats() const;
+	CaptureStats getCaptureStats() const;
+	void reportInputOverflow(Clock::time_point when = Clock::now());
+	void reportInputUnderflow(Clock::time_point when = Clock::now());
+	void setOverflowPolicy(OverflowPolicy policy) { overflowPolicy.store(policy); }
+	OverflowPolicy getOverflowPolicy() const { return overflowPolicy.load(); }
+	// Live audio is analysed as a sliding FFT_SIZE window, every hop samples, however the
+	// capture callback splits it up. A hop below FFT_SIZE publishes overlapping frames more
+	// often. While the worker is behind it drains the queue before analysing, so the hop
+	// stretches instead of buffers being dropped. Clamped to [MIN_HOP_SIZE, FFT_SIZE].
+	void setHopSize(size_t samples);
+	size_t getHopSize() const { return hopSize.load(); }
 	void setEQGains(float low, float mid, float high);
-	void setNoiseGateThreshold(float threshold);
+	// Takes effect from the next analysed frame
+	void setColourSettings(const ColourSettings& settings);
+	ColourSettings getColourSettings() const;
 	void reset();
 	void start();
 	void stop();
@@ -29,6 +102,8 @@ public:
 	FFTProcessor& getFFTProcessor() { return fftProcessor; }
 	ZeroCrossingDetector& getZeroCrossingDetector() { return zeroCrossingDetector; }
 
+	static constexpr size_t MIN_HOP_SIZE = 64;
+
 private:
 	static constexpr size_t QUEUE_SIZE = 16;
 	static constexpr size_t MAX_SAMPLES = 4096;
@@ -37,6 +112,7 @@ private:
 		std::vector<float> data;
 		size_t sampleCount;
 		float sampleRate;
+		Clock::time_point captureTime;
 
 		AudioBuffer() : data(MAX_SAMPLES), sampleCount(0), sampleRate(44100.0f) {}
 	};
@@ -44,6 +120,11 @@ private:
 	AudioBuffer audioQueue[QUEUE_SIZE];
 	std::atomic<size_t> writeIndex;
 	std::atomic<size_t> readIndex;
+	std::atomic<bool> skipOldest{false};	// the worker should drop its oldest queued buffer
+	std::atomic<OverflowPolicy> overflowPolicy{OverflowPolicy::DropNewest};
+	AudioBuffer pendingMerge;		// producer-owned: the merged or held-back buffer on overflow
+	AudioBuffer processingBuffer;	// worker-owned copy of the slot being analysed
+	std::atomic<size_t> hopSize{FFTProcessor::FFT_SIZE};
 	std::thread workerThread;
 	std::atomic<bool> running;
 	std::condition_variable dataAvailable;
@@ -52,16 +133,54 @@ private:
 	FFTProcessor fftProcessor;
 	ZeroCrossingDetector zeroCrossingDetector;
 
-	mutable std::mutex resultsMutex;
-	ColourMapper::ColourResult currentColour;
-	float currentDominantFrequency;
-	std::vector<FFTProcessor::FrequencyPeak> currentPeaks;
+	SnapshotExchange<AnalysisFrame> frames;
+	AnalysisFrame unpublishedFrame;	 // written instead when every spare slot is pinned
+	std::atomic<uint64_t> frameSequence{0};
+
+	mutable std::mutex colourSettingsMutex;
+	ColourSettings colourSettings;
+
+	std::mutex frameListenerMutex;
+	FrameListener frameListener;
+
+	LatencyTracker queueLatency;
+	LatencyTracker analysisLatency;
+	LatencyTracker colourLatency;
+	LatencyTracker totalLatency;
+
+	EventCounter droppedBufferEvents;
+	EventCounter mergedBufferEvents;
+	EventCounter truncatedSampleEvents;
+	EventCounter inputOverflowEvents;
+	EventCounter inputUnderflowEvents;
+
+	Metrics::Counter& droppedBuffers;
+	Metrics::Counter& mergedBuffers;
+	Metrics::Counter& truncatedSamples;
+	Metrics::Counter& inputOverflows;
+	Metrics::Counter& inputUnderflows;
+	Metrics::Counter& processedFrames;
+	Metrics::Counter& unpublishedFrames;
+	Metrics::Histogram& peaksPerFrame;
+	Metrics::Histogram& pipelineLatency;
 	
+	// Worker-owned sliding window: the newest FFT_SIZE live samples
+	std::vector<float> analysisWindow;
+	size_t windowNewSamples = 0;	// appended since the window was last analysed
+	float windowSampleRate = 0.0f;
+	Clock::time_point windowCaptureTime;	// of the newest buffer in the window
+
 	// Pre-allocated buffers for hot path optimization
-	std::vector<FFTProcessor::FrequencyPeak> tempPeaks;
 	std::vector<float> tempFreqs;
 	std::vector<float> tempMags;
 
 	void processingThreadFunc();
-	void processBuffer(const AudioBuffer& buffer);
+	void accumulate(const AudioBuffer& buffer);
+	// newSamples of samples, at its end, have not been analysed before
+	void processBuffer(std::span<const float> samples, size_t newSamples, float sampleRate,
+					   Clock::time_point captureTime, bool live = true);
+	void enqueue(const float* buffer, size_t sampleCount, float sampleRate,
+				 Clock::time_point captureTime);
+	void appendToPending(const float* buffer, size_t numSamples, float sampleRate,
+						 Clock::time_point captureTime);
 };
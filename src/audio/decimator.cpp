@@ -0,0 +1,78 @@
+#include "decimator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "fft_processor.h"
+
+void Decimator::configure(const int newFactor, const double inputRate, const size_t maxBlock) {
+	factor = std::max(newFactor, 1);
+	if (factor == 1) {
+		taps.clear();
+		work.clear();
+		phase = 0;
+		return;
+	}
+
+	// Passband to MAX_FREQ, stopband from outputRate - MAX_FREQ, cutoff midway at Nyquist
+	const double outputRate = inputRate / factor;
+	const double passband = static_cast<double>(FFTProcessor::MAX_FREQ);
+	const double transition = std::max(outputRate - 2.0 * passband, MIN_TRANSITION * outputRate);
+	const size_t tapCount =
+		static_cast<size_t>(std::ceil(TRANSITION_TAPS * inputRate / transition)) | 1;
+	taps.resize(tapCount);
+
+	const double cutoff = 0.5 / factor;	 // cycles per input sample
+	const double centre = static_cast<double>(tapCount - 1) / 2.0;
+	double sum = 0.0;
+	for (size_t i = 0; i < tapCount; ++i) {
+		const double x = static_cast<double>(i) - centre;
+		const double sinc =
+			x == 0.0 ? 2.0 * cutoff
+					 : std::sin(2.0 * std::numbers::pi * cutoff * x) / (std::numbers::pi * x);
+		const double position = static_cast<double>(i) / static_cast<double>(tapCount - 1);
+		const double window = 0.42 - 0.5 * std::cos(2.0 * std::numbers::pi * position) +
+							  0.08 * std::cos(4.0 * std::numbers::pi * position);
+		taps[i] = static_cast<float>(sinc * window);
+		sum += sinc * window;
+	}
+	for (auto& tap : taps) {
+		tap = static_cast<float>(static_cast<double>(tap) / sum);
+	}
+
+	work.assign(tapCount - 1 + maxBlock, 0.0f);
+	phase = 0;
+}
+
+size_t Decimator::process(float* samples, const size_t count) {
+	if (factor == 1) {
+		return count;
+	}
+
+	const size_t history = taps.size() - 1;
+	const size_t block = std::min(count, work.size() - history);
+	std::copy_n(samples, block, work.begin() + static_cast<std::ptrdiff_t>(history));
+
+	// Output n uses work[n, n + taps); the taps are symmetric, so no reversal is needed
+	const auto stride = static_cast<size_t>(factor);
+	size_t produced = 0;
+	size_t position = phase;
+	for (; position < block; position += stride) {
+		const float* window = work.data() + position;
+		float sum = 0.0f;
+		for (size_t k = 0; k < taps.size(); ++k) {
+			sum += window[k] * taps[k];
+		}
+		samples[produced++] = sum;
+	}
+	phase = position - block;
+
+	std::copy_n(work.begin() + static_cast<std::ptrdiff_t>(block), history, work.begin());
+	return produced;
+}
+
+void Decimator::reset() {
+	std::ranges::fill(work, 0.0f);
+	phase = 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Integer-factor downsampler for one channel, so 96 and 192 kHz capture can be analysed at
+// around 48 kHz with the same FFT_SIZE: the cost per frame stays put and bins stay narrow.
+// A Blackman-windowed sinc low-pass with its cutoff at the output Nyquist runs only at the
+// output positions. The filter is flat to FFTProcessor::MAX_FREQ and reaches full
+// rejection (about 75 dB) at the output rate minus MAX_FREQ, so whatever folds back lands
+// above MAX_FREQ. The taps are sized for that transition, so the 44.1 kHz family, with a
+// narrower transition, needs about twice as many as the 48 kHz family.
+class Decimator {
+public:
+	// Blackman taps needed per (input rate / transition width) for full stopband rejection
+	static constexpr double TRANSITION_TAPS = 6.0;
+	// Narrowest transition, as a fraction of the output rate, when a manual factor leaves no
+	// room above MAX_FREQ; the passband then ends below MAX_FREQ
+	static constexpr double MIN_TRANSITION = 0.05;
+
+	// maxBlock bounds the count passed to process; everything is allocated here
+	void configure(int factor, double inputRate, size_t maxBlock);
+	int getFactor() const { return factor; }
+	size_t getTapCount() const { return taps.size(); }
+
+	// Filters count samples and writes the decimated ones back over the start of samples,
+	// returning how many. Block boundaries do not matter: the phase and filter history
+	// carry over.
+	size_t process(float* samples, size_t count);
+	void reset();
+
+private:
+	int factor = 1;
+	std::vector<float> taps;
+	std::vector<float> work;  // history (taps - 1) followed by the current block
+	size_t phase = 0;		  // input samples to skip before the next output
+};
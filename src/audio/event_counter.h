@@ -0,0 +1,36 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lock-free tally of a recurring event plus when it last happened. Safe to record
+// from the audio callback and read from any thread.
+class EventCounter {
+public:
+	using Clock = std::chrono::steady_clock;
+
+	struct Snapshot {
+		uint64_t count;
+		Clock::time_point lastOccurrence;  // default-constructed if it never happened
+	};
+
+	void record(const uint64_t amount = 1, const Clock::time_point when = Clock::now()) {
+		count.fetch_add(amount, std::memory_order_relaxed);
+		lastTicks.store(when.time_since_epoch().count(), std::memory_order_relaxed);
+	}
+
+	Snapshot snapshot() const {
+		return {count.load(std::memory_order_relaxed),
+				Clock::time_point(Clock::duration(lastTicks.load(std::memory_order_relaxed)))};
+	}
+
+	void reset() {
+		count.store(0, std::memory_order_relaxed);
+		lastTicks.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<uint64_t> count{0};
+	std::atomic<Clock::rep> lastTicks{0};
+};
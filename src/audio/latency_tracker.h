@@ -0,0 +1,52 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+// Lock-free latency counter for one pipeline stage. Written by a single thread
+// (the audio worker), read from any thread.
+class LatencyTracker {
+public:
+	struct Snapshot {
+		float lastMs;
+		float averageMs;
+		float maxMs;
+		uint64_t samples;
+	};
+
+	void record(const std::chrono::steady_clock::duration duration) {
+		const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+		const uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+
+		lastMicros.store(value, std::memory_order_relaxed);
+		totalMicros.fetch_add(value, std::memory_order_relaxed);
+		count.fetch_add(1, std::memory_order_relaxed);
+		if (value > maxMicros.load(std::memory_order_relaxed)) {
+			maxMicros.store(value, std::memory_order_relaxed);
+		}
+	}
+
+	Snapshot snapshot() const {
+		const uint64_t samples = count.load(std::memory_order_relaxed);
+		const uint64_t total = totalMicros.load(std::memory_order_relaxed);
+		return {static_cast<float>(lastMicros.load(std::memory_order_relaxed)) / 1000.0f,
+				samples > 0 ? static_cast<float>(total / samples) / 1000.0f : 0.0f,
+				static_cast<float>(maxMicros.load(std::memory_order_relaxed)) / 1000.0f,
+				samples};
+	}
+
+	void reset() {
+		lastMicros.store(0, std::memory_order_relaxed);
+		maxMicros.store(0, std::memory_order_relaxed);
+		totalMicros.store(0, std::memory_order_relaxed);
+		count.store(0, std::memory_order_relaxed);
+	}
+
+private:
+	std::atomic<uint64_t> lastMicros{0};
+	std::atomic<uint64_t> maxMicros{0};
+	std::atomic<uint64_t> totalMicros{0};
+	std::atomic<uint64_t> count{0};
+};
@@ -0,0 +1,107 @@
+#include "signal_conditioner.h"
+
+#include <algorithm>
+#include <cmath>
+
+SignalConditioner::SignalConditioner(const int channelCount)
+	: dcRemovalAlpha(0.995f), noiseGateThreshold(0.0001f) {
+	setChannelCount(channelCount);
+}
+
+void SignalConditioner::setChannelCount(const int channelCount) {
+	const auto count = static_cast<size_t>(std::max(channelCount, 1));
+	previousInputs.resize(count, 0.0f);
+	previousOutputs.resize(count, 0.0f);
+}
+
+void SignalConditioner::filter(float* samples, const size_t count, const size_t channel) {
+	const float a = dcRemovalAlpha;
+	const float a2 = a * a;
+	const float a3 = a2 * a;
+	const float a4 = a2 * a2;
+	const float threshold = noiseGateThreshold;
+	const auto gate = [threshold](const float y) { return std::abs(y) < threshold ? 0.0f : y; };
+
+	float previousInput = previousInputs[channel];
+	float previousOutput = previousOutputs[channel];
+
+	// y[n] = x[n] - x[n-1] + a * y[n-1], expanded over four samples so all of them follow
+	// from the differences and the previous group's last output
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		float* group = samples + i;
+		const float d0 = group[0] - previousInput;
+		const float d1 = group[1] - group[0];
+		const float d2 = group[2] - group[1];
+		const float d3 = group[3] - group[2];
+		previousInput = group[3];
+
+		const float y0 = d0 + a * previousOutput;
+		const float y1 = d1 + a * d0 + a2 * previousOutput;
+		const float y2 = d2 + a * d1 + a2 * d0 + a3 * previousOutput;
+		const float y3 = d3 + a * d2 + a2 * d1 + a3 * d0 + a4 * previousOutput;
+		previousOutput = y3;
+
+		group[0] = gate(y0);
+		group[1] = gate(y1);
+		group[2] = gate(y2);
+		group[3] = gate(y3);
+	}
+
+	for (; i < count; ++i) {
+		const float sample = samples[i];
+		const float filteredSample = sample - previousInput + a * previousOutput;
+		previousInput = sample;
+		previousOutput = filteredSample;
+		samples[i] = gate(filteredSample);
+	}
+
+	previousInputs[channel] = previousInput;
+	previousOutputs[channel] = previousOutput;
+}
+
+void SignalConditioner::process(const float* interleaved, const size_t frameCount,
+								const int channelCount, const int channel, float* output) {
+	const auto stride = static_cast<size_t>(channelCount);
+	const auto channelIndex = static_cast<size_t>(channel);
+	if (channelIndex >= previousInputs.size()) {
+		return;
+	}
+
+	if (stride == 1) {
+		std::copy_n(interleaved, frameCount, output);
+	} else {
+		for (size_t i = 0; i < frameCount; ++i) {
+			output[i] = interleaved[i * stride + channelIndex];
+		}
+	}
+	filter(output, frameCount, channelIndex);
+}
+
+void SignalConditioner::processAll(const float* interleaved, const size_t frameCount,
+								   const int channelCount, const std::span<float* const> outputs) {
+	const auto stride = static_cast<size_t>(channelCount);
+	const size_t channels = std::min({stride, outputs.size(), previousInputs.size()});
+
+	// Deinterleaved in cache-sized runs of frames so the block is read from memory once,
+	// with each channel's loop free of the outputs indirection
+	constexpr size_t RUN = 256;
+	for (size_t start = 0; start < frameCount; start += RUN) {
+		const size_t end = std::min(start + RUN, frameCount);
+		for (size_t c = 0; c < channels; ++c) {
+			float* output = outputs[c];
+			const float* input = interleaved + c;
+			for (size_t i = start; i < end; ++i) {
+				output[i] = input[i * stride];
+			}
+		}
+	}
+	for (size_t c = 0; c < channels; ++c) {
+		filter(outputs[c], frameCount, c);
+	}
+}
+
+void SignalConditioner::reset() {
+	std::ranges::fill(previousInputs, 0.0f);
+	std::ranges::fill(previousOutputs, 0.0f);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Front end shared by live capture and offline analysis: picks one channel out of an
+// interleaved block, removes DC with a one-pole high-pass and applies the noise gate.
+// processAll does the same for every channel in one pass over the block.
+//
+// Samples are gathered into the output first and then filtered in place four at a time:
+// the recursion is unrolled so each group depends on the previous one only through a
+// single carried output, and the gate is a select rather than a branch, so the compiler
+// can keep the whole group in vector registers. Nothing here allocates.
+class SignalConditioner {
+public:
+	explicit SignalConditioner(int channelCount = 1);
+
+	void setChannelCount(int channelCount);
+	void setDcRemovalAlpha(const float alpha) { dcRemovalAlpha = alpha; }
+	void setNoiseGateThreshold(const float threshold) { noiseGateThreshold = threshold; }
+	float getDcRemovalAlpha() const { return dcRemovalAlpha; }
+	float getNoiseGateThreshold() const { return noiseGateThreshold; }
+
+	void process(const float* interleaved, size_t frameCount, int channelCount, int channel,
+				 float* output);
+	// outputs[c] receives channel c; channels past outputs.size() are skipped
+	void processAll(const float* interleaved, size_t frameCount, int channelCount,
+					std::span<float* const> outputs);
+	void reset();
+
+private:
+	// DC removal and gate in place over one channel's contiguous samples
+	void filter(float* samples, size_t count, size_t channel);
+
+	std::vector<float> previousInputs;
+	std::vector<float> previousOutputs;
+	float dcRemovalAlpha;
+	float noiseGateThreshold;
+};
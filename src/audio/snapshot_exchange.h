@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Single-writer, multi-reader hand-off of a large value without locks or per-publish
+// allocation. The writer fills a free slot in place, reusing whatever capacity the slot's
+// members already have, and publishes it with one atomic store. Readers pin the latest
+// slot for as long as they hold the Snapshot, so they always see one complete value.
+// Readers never block the writer: beginWrite() skips pinned slots and returns nullptr
+// only if every spare slot is pinned at once.
+template <typename T, size_t Slots = 6> class SnapshotExchange {
+	static_assert(Slots >= 3, "need the published slot, one being written and one spare");
+
+public:
+	class Snapshot {
+	public:
+		Snapshot() = default;
+		~Snapshot() { release(); }
+
+		Snapshot(Snapshot&& other) noexcept : value(other.value), pins(other.pins) {
+			other.value = nullptr;
+			other.pins = nullptr;
+		}
+
+		Snapshot& operator=(Snapshot&& other) noexcept {
+			if (this != &other) {
+				release();
+				value = other.value;
+				pins = other.pins;
+				other.value = nullptr;
+				other.pins = nullptr;
+			}
+			return *this;
+		}
+
+		Snapshot(const Snapshot&) = delete;
+		Snapshot& operator=(const Snapshot&) = delete;
+
+		const T& operator*() const { return *value; }
+		const T* operator->() const { return value; }
+		explicit operator bool() const { return value != nullptr; }
+
+	private:
+		friend class SnapshotExchange;
+
+		Snapshot(const T* snapshotValue, std::atomic<uint32_t>* snapshotPins)
+			: value(snapshotValue), pins(snapshotPins) {}
+
+		void release() {
+			if (pins) {
+				pins->fetch_sub(1, std::memory_order_release);
+			}
+		}
+
+		const T* value = nullptr;
+		std::atomic<uint32_t>* pins = nullptr;
+	};
+
+	SnapshotExchange() {
+		for (auto& count : pins) {
+			count.store(0, std::memory_order_relaxed);
+		}
+	}
+
+	// Writer only, before the first publish: lets the owner size every slot up front so
+	// later frames never grow one
+	template <typename Init> void initialiseSlots(Init&& init) {
+		for (auto& slot : slots) {
+			init(slot);
+		}
+	}
+
+	// Writer only. The slot stays private until publish().
+	T* beginWrite() {
+		const size_t current = latest.load(std::memory_order_relaxed);
+		for (size_t offset = 1; offset < Slots; ++offset) {
+			const size_t candidate = (current + offset) % Slots;
+			if (pins[candidate].load(std::memory_order_seq_cst) == 0) {
+				writing = candidate;
+				return &slots[candidate];
+			}
+		}
+		return nullptr;
+	}
+
+	void publish() { latest.store(writing, std::memory_order_seq_cst); }
+
+	// Lock-free; retries only if a publish lands between loading and pinning the slot.
+	Snapshot read() const {
+		for (;;) {
+			const size_t index = latest.load(std::memory_order_seq_cst);
+			pins[index].fetch_add(1, std::memory_order_seq_cst);
+			if (latest.load(std::memory_order_seq_cst) == index) {
+				return Snapshot(&slots[index], &pins[index]);
+			}
+			pins[index].fetch_sub(1, std::memory_order_relaxed);
+		}
+	}
+
+private:
+	std::array<T, Slots> slots{};
+	mutable std::array<std::atomic<uint32_t>, Slots> pins;
+	std::atomic<size_t> latest{0};
+	size_t writing = 0;
+};
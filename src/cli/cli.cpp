@@ -1,6 +1,7 @@
 #include "cli.h"
 
 #include <iostream>
+#include <cstdlib>
 #include <cstring>
 #include "version.h"
 
@@ -22,11 +23,198 @@ Arguments Arguments::parseCommandLine(int argc, char* argv[]) {
         else if (strcmp(argv[i], "--version") == 0 || strcmp(argv[i], "-v") == 0) {
             args.showVersion = true;
         }
+        else if (strcmp(argv[i], "--list-devices") == 0) {
+            args.listDevices = true;
+        }
         else if (strcmp(argv[i], "--device") == 0 || strcmp(argv[i], "-d") == 0) {
             if (i + 1 < argc) {
                 args.audioDevice = argv[++i];
             }
         }
+        else if (strcmp(argv[i], "--overflow-policy") == 0) {
+            if (i + 1 < argc) {
+                const char* policy = argv[++i];
+                if (strcmp(policy, "drop-newest") == 0) {
+                    args.overflowPolicy = AudioProcessor::OverflowPolicy::DropNewest;
+                } else if (strcmp(policy, "drop-oldest") == 0) {
+                    args.overflowPolicy = AudioProcessor::OverflowPolicy::DropOldest;
+                } else if (strcmp(policy, "merge") == 0) {
+                    args.overflowPolicy = AudioProcessor::OverflowPolicy::Merge;
+                } else {
+                    std::cerr << "Unknown overflow policy: " << policy << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--noise-floor") == 0) {
+            if (i + 1 < argc) {
+                const char* mode = argv[++i];
+                if (strcmp(mode, "global") == 0) {
+                    args.noiseFloorMode = FFTProcessor::NoiseFloorMode::Global;
+                } else if (strcmp(mode, "per-bin") == 0) {
+                    args.noiseFloorMode = FFTProcessor::NoiseFloorMode::PerBin;
+                } else {
+                    std::cerr << "Unknown noise floor mode: " << mode << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--interpolation") == 0) {
+            if (i + 1 < argc) {
+                const char* method = argv[++i];
+                if (strcmp(method, "parabolic") == 0) {
+                    args.peakInterpolation = FFTProcessor::PeakInterpolation::Parabolic;
+                } else if (strcmp(method, "gaussian") == 0) {
+                    args.peakInterpolation = FFTProcessor::PeakInterpolation::Gaussian;
+                } else if (strcmp(method, "phase-vocoder") == 0) {
+                    args.peakInterpolation = FFTProcessor::PeakInterpolation::PhaseVocoder;
+                } else {
+                    std::cerr << "Unknown interpolation method: " << method << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--fft-backend") == 0) {
+            if (i + 1 < argc) {
+                const char* backend = argv[++i];
+                if (strcmp(backend, "kissfft") == 0) {
+                    args.fftBackend = FFTBackend::Kind::KissFFT;
+                } else if (strcmp(backend, "fftw") == 0) {
+                    if (FFTBackend::isAvailable(FFTBackend::Kind::FFTW)) {
+                        args.fftBackend = FFTBackend::Kind::FFTW;
+                    } else {
+                        std::cerr << "FFT backend not built into this binary: " << backend << std::endl;
+                    }
+                } else {
+                    std::cerr << "Unknown FFT backend: " << backend << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--buffer-size") == 0) {
+            if (i + 1 < argc) {
+                const long frames = std::strtol(argv[++i], nullptr, 10);
+                if (frames >= 0) {
+                    args.capture.framesPerBuffer = static_cast<int>(frames);
+                } else {
+                    std::cerr << "Invalid buffer size: " << argv[i] << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--latency") == 0) {
+            if (i + 1 < argc) {
+                const double milliseconds = std::strtod(argv[++i], nullptr);
+                if (milliseconds >= 0.0) {
+                    args.capture.suggestedLatency = milliseconds / 1000.0;
+                } else {
+                    std::cerr << "Invalid latency: " << argv[i] << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--sample-rate") == 0) {
+            if (i + 1 < argc) {
+                const double rate = std::strtod(argv[++i], nullptr);
+                if (rate >= 0.0) {
+                    args.capture.sampleRate = rate;
+                } else {
+                    std::cerr << "Invalid sample rate: " << argv[i] << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--decimate") == 0) {
+            if (i + 1 < argc) {
+                const char* factor = argv[++i];
+                const long value = std::strtol(factor, nullptr, 10);
+                if (strcmp(factor, "auto") == 0) {
+                    args.capture.decimation = 0;
+                } else if (value >= 1 && value <= AudioInput::MAX_DECIMATION) {
+                    args.capture.decimation = static_cast<int>(value);
+                } else {
+                    std::cerr << "Decimation must be auto or 1-" << AudioInput::MAX_DECIMATION
+                              << ": " << factor << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--hop-size") == 0) {
+            if (i + 1 < argc) {
+                const long samples = std::strtol(argv[++i], nullptr, 10);
+                if (samples >= static_cast<long>(AudioProcessor::MIN_HOP_SIZE) &&
+                    samples <= FFTProcessor::FFT_SIZE) {
+                    args.hopSize = static_cast<size_t>(samples);
+                } else {
+                    std::cerr << "Hop size must be between " << AudioProcessor::MIN_HOP_SIZE
+                              << " and " << FFTProcessor::FFT_SIZE << ": " << argv[i] << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--multichannel") == 0) {
+            args.multichannel = true;
+        }
+        else if (strcmp(argv[i], "--multi-resolution") == 0) {
+            args.multiResolution = true;
+        }
+        else if (strcmp(argv[i], "--input-file") == 0 || strcmp(argv[i], "-i") == 0) {
+            if (i + 1 < argc) {
+                args.inputFile = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--stream") == 0) {
+            if (i + 1 < argc) {
+                const char* format = argv[++i];
+                if (strcmp(format, "ndjson") == 0) {
+                    args.streamFormat = StreamFormat::Ndjson;
+                } else if (strcmp(format, "binary") == 0) {
+                    args.streamFormat = StreamFormat::Binary;
+                } else {
+                    std::cerr << "Unknown stream format: " << format << std::endl;
+                }
+            }
+        }
+        // Shorthand for --stream; any other value is an offline output path, so a file
+        // called ndjson is written with -o ndjson or --output=./ndjson
+        else if (strncmp(argv[i], "--output=", 9) == 0) {
+            const char* value = argv[i] + 9;
+            if (strcmp(value, "ndjson") == 0) {
+                args.streamFormat = StreamFormat::Ndjson;
+            } else if (strcmp(value, "binary") == 0) {
+                args.streamFormat = StreamFormat::Binary;
+            } else {
+                args.outputFile = value;
+            }
+        }
+        else if (strcmp(argv[i], "--output") == 0 || strcmp(argv[i], "-o") == 0) {
+            if (i + 1 < argc) {
+                args.outputFile = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--batch") == 0) {
+            if (i + 1 < argc) {
+                args.batchSource = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--output-dir") == 0) {
+            if (i + 1 < argc) {
+                args.outputDir = argv[++i];
+            }
+        }
+        else if (strcmp(argv[i], "--jobs") == 0 || strcmp(argv[i], "-j") == 0) {
+            if (i + 1 < argc) {
+                args.jobs = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+            }
+        }
+        else if (strcmp(argv[i], "--format") == 0) {
+            if (i + 1 < argc) {
+                const char* format = argv[++i];
+                if (strcmp(format, "csv") == 0) {
+                    args.outputFormat = Offline::OutputFormat::Csv;
+                } else if (strcmp(format, "binary") == 0) {
+                    args.outputFormat = Offline::OutputFormat::Binary;
+                } else {
+                    std::cerr << "Unknown output format: " << format << std::endl;
+                }
+            }
+        }
+        else if (strcmp(argv[i], "--metrics-socket") == 0) {
+            if (i + 1 < argc) {
+                args.metricsSocket = argv[++i];
+            }
+        }
         else {
             std::cerr << "Unknown argument: " << argv[i] << std::endl;
             std::cerr << "Use --help for usage information." << std::endl;
@@ -43,8 +231,53 @@ void Arguments::printHelp() {
     std::cout << "  --headless, -h        Run in headless mode (no GUI)\n";
     std::cout << "  --enable-api          Start API server automatically\n";
     std::cout << "  --device, -d <name>   Use specific audio device\n";
+    std::cout << "  --list-devices        Print available input devices and exit\n";
+    std::cout << "  --metrics-socket <path>\n";
+    std::cout << "                        Serve Prometheus-style metrics on a Unix socket\n";
+    std::cout << "  --input-file, -i <path>\n";
+    std::cout << "                        Analyse a WAV file offline instead of live input\n";
+    std::cout << "  --output, -o <path>   Where to write --input-file results (default: stdout)\n";
+    std::cout << "  --stream <ndjson|binary>\n";
+    std::cout << "                        Stream one record per live analysis frame to stdout\n";
+    std::cout << "                        (implies --headless, no terminal UI); --output=ndjson\n";
+    std::cout << "                        and --output=binary are shorthands for it\n";
+    std::cout << "  --batch <dir|list>    Analyse every WAV in a directory or list file\n";
+    std::cout << "  --output-dir <path>   Where to write batch results, mirroring input folders\n";
+    std::cout << "                        (default: next to input)\n";
+    std::cout << "  --jobs, -j <n>        Batch worker threads (default: all cores)\n";
+    std::cout << "  --format <csv|binary> Offline output format (default: csv)\n";
     std::cout << "  --version, -v         Show version information\n";
     std::cout << "  --help                Show this help message\n\n";
+    std::cout << "Live analysis options (--headless and --stream only; the GUI uses its own\n";
+    std::cout << "settings):\n";
+    std::cout << "  --multichannel        Analyse every input channel, one record per channel per\n";
+    std::cout << "                        frame (default: first channel)\n";
+    std::cout << "  --buffer-size <frames>\n";
+    std::cout << "                        Frames per capture callback; 0 lets the host choose\n";
+    std::cout << "                        (default: 2048)\n";
+    std::cout << "  --latency <ms>        Suggested input latency (default: the device's low\n";
+    std::cout << "                        input latency)\n";
+    std::cout << "  --sample-rate <hz>    Capture sample rate (default: the device's own)\n";
+    std::cout << "  --decimate <n|auto>   Analyse every nth sample, after an anti-aliasing filter;\n";
+    std::cout << "                        auto brings 88.2-192 kHz capture down to 44.1-48 kHz\n";
+    std::cout << "                        (default: 1)\n";
+    std::cout << "  --hop-size <samples>  Analyse the last 2048 samples every <samples>, 64-2048;\n";
+    std::cout << "                        pair a small hop with a small buffer for low latency\n";
+    std::cout << "                        (default: 2048)\n";
+    std::cout << "  --overflow-policy <drop-newest|drop-oldest|merge>\n";
+    std::cout << "                        What to do with audio when analysis falls behind\n";
+    std::cout << "  --noise-floor <global|per-bin>\n";
+    std::cout << "                        Peak threshold: one spectrum-wide level, or also each\n";
+    std::cout << "                        bin's own tracked floor (default: global)\n";
+    std::cout << "  --interpolation <parabolic|gaussian|phase-vocoder>\n";
+    std::cout << "                        How peak frequencies are refined between FFT bins\n";
+    std::cout << "                        (default: parabolic)\n";
+    std::cout << "  --multi-resolution    Take bass peaks from a longer FFT window: finer pitch\n";
+    std::cout << "                        below 250 Hz, but they react more slowly\n";
+    std::cout << "  --fft-backend <kissfft|fftw>\n";
+    std::cout << "                        Transform implementation; fftw only if built with\n";
+    std::cout << "                        ENABLE_FFTW_BACKEND (default: kissfft)\n";
+    std::cout << "\n";
     std::cout << "In headless mode:\n";
     std::cout << "  - Use arrow keys to navigate audio devices\n";
     std::cout << "  - Press Enter to select a device\n";
@@ -52,6 +285,48 @@ void Arguments::printHelp() {
     std::cout << "  - Press 'a' to toggle API server\n\n";
 }
 
+void Arguments::printDaemonHelp() {
+    std::cout << "synesthesia-daemon - Headless capture and colour streaming service\n\n";
+    std::cout << "Usage: synesthesia-daemon [OPTIONS]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --device, -d <name>   Capture from the first device whose name contains <name>\n";
+    std::cout << "                        (default: first input device)\n";
+    std::cout << "  --list-devices        Print available input devices and exit\n";
+    std::cout << "  --enable-api          Serve colour data on the API socket\n";
+    std::cout << "  --multichannel        Analyse every input channel of the device, each streamed\n";
+    std::cout << "                        as its own colour message (default: first channel only)\n";
+    std::cout << "  --buffer-size <frames>\n";
+    std::cout << "                        Frames per capture callback; 0 lets the host choose\n";
+    std::cout << "                        (default: 2048)\n";
+    std::cout << "  --latency <ms>        Suggested input latency (default: the device's low\n";
+    std::cout << "                        input latency)\n";
+    std::cout << "  --sample-rate <hz>    Capture sample rate (default: the device's own)\n";
+    std::cout << "  --decimate <n|auto>   Analyse every nth sample, after an anti-aliasing filter;\n";
+    std::cout << "                        auto brings 88.2-192 kHz capture down to 44.1-48 kHz\n";
+    std::cout << "                        (default: 1)\n";
+    std::cout << "  --hop-size <samples>  Analyse the last 2048 samples every <samples>, 64-2048;\n";
+    std::cout << "                        pair a small hop with a small buffer for low latency\n";
+    std::cout << "                        (default: 2048)\n";
+    std::cout << "  --overflow-policy <drop-newest|drop-oldest|merge>\n";
+    std::cout << "                        What to do with audio when analysis falls behind\n";
+    std::cout << "  --noise-floor <global|per-bin>\n";
+    std::cout << "                        Peak threshold: one spectrum-wide level, or also each\n";
+    std::cout << "                        bin's own tracked floor (default: global)\n";
+    std::cout << "  --interpolation <parabolic|gaussian|phase-vocoder>\n";
+    std::cout << "                        How peak frequencies are refined between FFT bins\n";
+    std::cout << "                        (default: parabolic)\n";
+    std::cout << "  --multi-resolution    Take bass peaks from a longer FFT window: finer pitch\n";
+    std::cout << "                        below 250 Hz, but they react more slowly\n";
+    std::cout << "  --fft-backend <kissfft|fftw>\n";
+    std::cout << "                        Transform implementation; fftw only if built with\n";
+    std::cout << "                        ENABLE_FFTW_BACKEND (default: kissfft)\n";
+    std::cout << "  --metrics-socket <path>\n";
+    std::cout << "                        Serve Prometheus-style metrics on a Unix socket\n";
+    std::cout << "  --version, -v         Show version information\n";
+    std::cout << "  --help                Show this help message\n\n";
+    std::cout << "Runs until SIGINT or SIGTERM. Nothing is read from the terminal.\n";
+}
+
 void Arguments::printVersion() {
     std::cout << "Synesthesia " << SYNESTHESIA_VERSION_STRING << std::endl;
     std::cout << "Built with C++20" << std::endl;
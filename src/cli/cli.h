@@ -2,6 +2,10 @@
 
 #include <string>
 
+#include "audio_input.h"
+#include "frame_stream.h"
+#include "frame_writer.h"
+
 namespace CLI {
 
 struct Arguments {
@@ -9,10 +13,28 @@ struct Arguments {
     bool enableAPI = false;
     bool showHelp = false;
     bool showVersion = false;
+    bool listDevices = false;
     std::string audioDevice;
+    std::string metricsSocket;
+    std::string inputFile;
+    std::string outputFile;
+    StreamFormat streamFormat = StreamFormat::None;
+    Offline::OutputFormat outputFormat = Offline::OutputFormat::Csv;
+    std::string batchSource;
+    std::string outputDir;
+    unsigned jobs = 0;
+    AudioProcessor::OverflowPolicy overflowPolicy = AudioProcessor::OverflowPolicy::DropNewest;
+    FFTProcessor::NoiseFloorMode noiseFloorMode = FFTProcessor::NoiseFloorMode::Global;
+    FFTProcessor::PeakInterpolation peakInterpolation = FFTProcessor::PeakInterpolation::Parabolic;
+    bool multiResolution = false;
+    FFTBackend::Kind fftBackend = FFTBackend::Kind::KissFFT;
+    bool multichannel = false;
+    AudioInput::CaptureConfig capture;
+    size_t hopSize = FFTProcessor::FFT_SIZE;
     
     static Arguments parseCommandLine(int argc, char* argv[]);
     static void printHelp();
+    static void printDaemonHelp();
     static void printVersion();
 };
 
@@ -0,0 +1,185 @@
+#include "daemon.h"
+
+#include <csignal>
+#include <iostream>
+#include <thread>
+
+#ifdef ENABLE_API_SERVER
+#include "api/synesthesia_api_integration.h"
+#endif
+
+namespace CLI {
+
+std::atomic<bool> Daemon::stopRequested{false};
+
+Daemon::Daemon() = default;
+
+Daemon::~Daemon() = default;
+
+void Daemon::signalHandler(int /* signal */) {
+    stopRequested.store(true);
+}
+
+void Daemon::listDevices() {
+    AudioInput input;
+    for (const auto& device : AudioInput::getInputDevices()) {
+        std::cout << device.paIndex << "\t" << device.maxChannels << "\t" << device.name << "\n";
+    }
+}
+
+bool Daemon::openDevice(const std::string& preferredDevice) {
+    const auto devices = AudioInput::getInputDevices();
+    if (devices.empty()) {
+        std::cerr << "No audio input devices found" << std::endl;
+        return false;
+    }
+
+    const AudioInput::DeviceInfo* chosen = &devices.front();
+    if (!preferredDevice.empty()) {
+        chosen = nullptr;
+        for (const auto& device : devices) {
+            if (device.name.find(preferredDevice) != std::string::npos) {
+                chosen = &device;
+                break;
+            }
+        }
+        if (!chosen) {
+            std::cerr << "No input device matches \"" << preferredDevice << "\"" << std::endl;
+            return false;
+        }
+    }
+
+    if (!audioInput.initStream(chosen->paIndex,
+                               audioInput.isMultichannel() ? chosen->maxChannels : 1)) {
+        std::cerr << "Failed to open input device " << chosen->name << std::endl;
+        return false;
+    }
+
+    const AudioFormat& format = audioInput.getFormat();
+    std::cout << "Capturing from " << chosen->name << " at " << format.captureRate << " Hz";
+    if (format.decimation > 1) {
+        std::cout << ", analysed at " << format.analysisRate() << " Hz";
+    }
+    if (audioInput.getAnalysedChannelCount() > 1) {
+        std::cout << " (" << audioInput.getAnalysedChannelCount() << " channels)";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+int Daemon::run(const Arguments& args) {
+    stopRequested.store(false);
+
+    struct sigaction action {};
+    action.sa_handler = signalHandler;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, nullptr);
+    sigaction(SIGTERM, &action, nullptr);
+    std::signal(SIGPIPE, SIG_IGN);
+
+    audioInput.setMultichannel(args.multichannel);
+    audioInput.setCaptureConfig(args.capture);
+    audioInput.setOverflowPolicy(args.overflowPolicy);
+    audioInput.setHopSize(args.hopSize);
+    audioInput.getFFTProcessor().setNoiseFloorMode(args.noiseFloorMode);
+    audioInput.getFFTProcessor().setPeakInterpolation(args.peakInterpolation);
+    audioInput.getFFTProcessor().setMultiResolution(args.multiResolution);
+    audioInput.getFFTProcessor().setFFTBackend(args.fftBackend);
+    if (!openDevice(args.audioDevice)) {
+        return 1;
+    }
+
+#ifdef ENABLE_API_SERVER
+    if (args.enableAPI) {
+        auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
+        if (!api.startServer()) {
+            std::cerr << "Failed to start API server" << std::endl;
+            return 1;
+        }
+        std::cout << "API server started" << std::endl;
+    }
+#else
+    if (args.enableAPI) {
+        std::cerr << "API server support is not compiled in, ignoring --enable-api" << std::endl;
+    }
+#endif
+
+    auto nextStatus = std::chrono::steady_clock::now() + STATUS_INTERVAL;
+    while (!stopRequested.load()) {
+        publishFrame();
+
+        if (const auto now = std::chrono::steady_clock::now(); now >= nextStatus) {
+            logStatus(false);
+            nextStatus = now + STATUS_INTERVAL;
+        }
+        std::this_thread::sleep_for(FRAME_INTERVAL);
+    }
+
+    std::cout << "Shutting down" << std::endl;
+    logStatus(true);
+
+#ifdef ENABLE_API_SERVER
+    if (args.enableAPI) {
+        Synesthesia::SynesthesiaAPIIntegration::getInstance().stopServer();
+    }
+#endif
+
+    return 0;
+}
+
+void Daemon::publishFrame() {
+#ifdef ENABLE_API_SERVER
+    auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
+    const int channels = audioInput.getAnalysedChannelCount();
+    publishedSequences.resize(static_cast<size_t>(channels), 0);
+    for (int channel = 0; channel < channels; ++channel) {
+        // The poll outpaces the analysis hop; a frame already sent is not sent again
+        const auto frame = audioInput.getLatestFrame(channel);
+        uint64_t& published = publishedSequences[static_cast<size_t>(channel)];
+        if (frame->sequence == published) {
+            continue;
+        }
+        published = frame->sequence;
+
+        frequencies.clear();
+        magnitudes.clear();
+        for (const auto& peak : frame->peaks) {
+            frequencies.push_back(peak.frequency);
+            magnitudes.push_back(peak.magnitude);
+        }
+
+        api.updateFinalColour(frame->colour.r, frame->colour.g, frame->colour.b, frequencies, magnitudes,
+                              static_cast<uint32_t>(frame->sampleRate), FFTProcessor::FFT_SIZE,
+                              frame->captureTime, static_cast<uint16_t>(channel),
+                              static_cast<uint16_t>(channels));
+        if (channel == 0) {
+            api.updateSpectralFeatures(frame->features, frame->captureTime);
+        }
+    }
+    api.updateCaptureStats(audioInput.getCaptureStats());
+#endif
+}
+
+// Quiet unless something was lost since the last report, so a healthy daemon does not
+// fill the journal
+void Daemon::logStatus(const bool force) {
+    const auto stats = audioInput.getCaptureStats();
+    const uint64_t lossEvents = stats.droppedBuffers.count + stats.mergedBuffers.count +
+                                stats.truncatedSamples.count + stats.inputOverflows.count +
+                                stats.inputUnderflows.count;
+    if (!force && lossEvents == lastLossEvents) {
+        return;
+    }
+    lastLossEvents = lossEvents;
+
+    const auto latency = audioInput.getLatencyStats();
+    std::cout << "dropped=" << stats.droppedBuffers.count
+              << " merged=" << stats.mergedBuffers.count
+              << " truncated_samples=" << stats.truncatedSamples.count
+              << " overflows=" << stats.inputOverflows.count
+              << " underflows=" << stats.inputUnderflows.count
+              << " latency_avg_ms=" << latency.total.averageMs
+              << " latency_max_ms=" << latency.total.maxMs << std::endl;
+}
+
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "audio_input.h"
+#include "cli.h"
+
+namespace CLI {
+
+// Non-interactive capture loop for running under a service manager. Everything comes
+// from flags: no terminal setup, no prompts and no screen redraws. Progress and problems
+// are written as single log lines so they read cleanly in the journal.
+class Daemon {
+public:
+    Daemon();
+    ~Daemon();
+
+    Daemon(const Daemon&) = delete;
+    Daemon& operator=(const Daemon&) = delete;
+
+    // Runs until SIGINT/SIGTERM. Returns the process exit code.
+    int run(const Arguments& args);
+    static void listDevices();
+
+private:
+    static constexpr auto FRAME_INTERVAL = std::chrono::milliseconds(16);
+    static constexpr auto STATUS_INTERVAL = std::chrono::seconds(60);
+
+    AudioInput audioInput;
+    uint64_t lastLossEvents = 0;
+    std::vector<float> frequencies;
+    std::vector<float> magnitudes;
+    std::vector<uint64_t> publishedSequences;  // per channel, of the last frame sent
+
+    bool openDevice(const std::string& preferredDevice);
+    void publishFrame();
+    void logStatus(bool force);
+
+    static void signalHandler(int signal);
+    static std::atomic<bool> stopRequested;
+};
+
+}
@@ -0,0 +1,193 @@
+#include "frame_stream.h"
+
+#include <poll.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+
+#ifdef ENABLE_API_SERVER
+#include "api/common/serialisation.h"
+#endif
+
+namespace CLI {
+
+namespace {
+
+void appendNumber(std::string& out, const float value) {
+    if (!std::isfinite(value)) {
+        out += "null";
+        return;
+    }
+    char digits[32];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+void appendNumber(std::string& out, const uint64_t value) {
+    char digits[24];
+    const auto result = std::to_chars(digits, digits + sizeof(digits), value);
+    out.append(digits, result.ptr);
+}
+
+}
+
+struct FrameStreamer::Scratch {
+    std::string record;
+#ifdef ENABLE_API_SERVER
+    std::vector<Synesthesia::API::ColourData> colours;
+    std::vector<uint8_t> message;
+#endif
+};
+
+FrameStreamer::FrameStreamer(StreamFormat streamFormat, int channels, int descriptor)
+    : format(streamFormat), channelCount(std::max(channels, 1)), fd(descriptor) {
+    for (int channel = 0; channel < channelCount; ++channel) {
+        scratch.push_back(std::make_unique<Scratch>());
+    }
+    pending.reserve(64 * 1024);
+    writing.reserve(64 * 1024);
+}
+
+FrameStreamer::~FrameStreamer() = default;
+
+void FrameStreamer::capture(const AnalysisFrame& frame, const int channel) {
+    if (channel < 0 || channel >= channelCount) {
+        return;
+    }
+    Scratch& channelScratch = *scratch[static_cast<size_t>(channel)];
+    std::string& record = channelScratch.record;
+    const auto timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(frame.captureTime.time_since_epoch())
+            .count());
+
+    record.clear();
+    if (format == StreamFormat::Ndjson) {
+        formatNdjson(frame, channel, timestamp, record);
+    } else if (format == StreamFormat::Binary) {
+        formatBinary(frame, channel, timestamp, channelScratch);
+    }
+
+    std::lock_guard lock(pendingMutex);
+    if (pending.size() + record.size() > MAX_PENDING_BYTES) {
+        droppedRecords.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    pending += record;
+}
+
+void FrameStreamer::formatNdjson(const AnalysisFrame& frame, const int channel,
+                                 const uint64_t timestamp, std::string& record) {
+    const auto& colour = frame.colour;
+    const auto& peaks = frame.peaks;
+
+    record += "{\"sequence\":";
+    appendNumber(record, frame.sequence);
+    record += ",\"channel\":";
+    appendNumber(record, static_cast<uint64_t>(channel));
+    record += ",\"timestamp_us\":";
+    appendNumber(record, timestamp);
+    record += ",\"dominant_frequency\":";
+    appendNumber(record, frame.dominantFrequency);
+    record += ",\"wavelength\":";
+    appendNumber(record, colour.dominantWavelength);
+    record += ",\"loudness\":";
+    appendNumber(record, frame.loudness);
+    record += ",\"rgb\":[";
+    appendNumber(record, colour.r);
+    record += ',';
+    appendNumber(record, colour.g);
+    record += ',';
+    appendNumber(record, colour.b);
+    record += "],\"lab\":[";
+    appendNumber(record, colour.L);
+    record += ',';
+    appendNumber(record, colour.a);
+    record += ',';
+    appendNumber(record, colour.b_comp);
+    record += "],\"features\":{\"flatness\":";
+    appendNumber(record, frame.features.flatness);
+    record += ",\"centroid\":";
+    appendNumber(record, frame.features.centroid);
+    record += ",\"spread\":";
+    appendNumber(record, frame.features.spread);
+    record += ",\"rolloff\":";
+    appendNumber(record, frame.features.rolloff);
+    record += ",\"flux\":";
+    appendNumber(record, frame.features.flux);
+    record += ",\"rms\":";
+    appendNumber(record, frame.features.rms);
+    record += "},\"peaks\":[";
+    for (size_t i = 0; i < peaks.size(); ++i) {
+        if (i > 0) {
+            record += ',';
+        }
+        record += '[';
+        appendNumber(record, peaks[i].frequency);
+        record += ',';
+        appendNumber(record, peaks[i].magnitude);
+        record += ']';
+    }
+    record += "]}\n";
+}
+
+void FrameStreamer::formatBinary(const AnalysisFrame& frame, const int channel,
+                                 const uint64_t timestamp, Scratch& channelScratch) {
+#ifdef ENABLE_API_SERVER
+    using Synesthesia::API::ColourData;
+
+    const auto& colour = frame.colour;
+    auto& colours = channelScratch.colours;
+    auto& message = channelScratch.message;
+    colours.clear();
+    colours.push_back({frame.dominantFrequency, colour.dominantWavelength, colour.r, colour.g,
+                       colour.b, frame.loudness, 0.0f});
+    for (const auto& peak : frame.peaks) {
+        colours.push_back({peak.frequency, ColourMapper::logFrequencyToWavelength(peak.frequency),
+                           colour.r, colour.g, colour.b, peak.magnitude, 0.0f});
+    }
+
+    Synesthesia::API::MessageSerialiser::serialiseColourDataIntoBuffer(
+        message, colours, static_cast<uint32_t>(frame.sampleRate), FFTProcessor::FFT_SIZE,
+        timestamp, static_cast<uint32_t>(frame.sequence), static_cast<uint16_t>(channel),
+        static_cast<uint16_t>(channelCount));
+    channelScratch.record.append(reinterpret_cast<const char*>(message.data()), message.size());
+#else
+    (void)frame;
+    (void)channel;
+    (void)timestamp;
+    (void)channelScratch;
+#endif
+}
+
+bool FrameStreamer::flush() {
+    {
+        std::lock_guard lock(pendingMutex);
+        writing.swap(pending);
+    }
+
+    size_t offset = 0;
+    while (offset < writing.size()) {
+        const ssize_t written = write(fd, writing.data() + offset, writing.size() - offset);
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            if (errno == EAGAIN) {
+                pollfd ready{fd, POLLOUT, 0};
+                poll(&ready, 1, -1);
+                continue;
+            }
+            writing.clear();
+            return false;
+        }
+        offset += static_cast<size_t>(written);
+    }
+
+    writing.clear();
+    return true;
+}
+
+}
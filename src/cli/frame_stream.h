@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "analysis_frame.h"
+
+namespace CLI {
+
+enum class StreamFormat { None, Ndjson, Binary };
+
+// Writes one record per analysis frame to a file descriptor (normally stdout) for piping
+// into other processes. Records are formatted on the analysis worker straight after the
+// frame is published and written out by the owning thread, so slow readers never stall
+// analysis; past MAX_PENDING_BYTES whole records are dropped and counted instead. With
+// several channels each one's frames become records of their own, and sequence numbers
+// count per channel.
+//
+// ndjson: {"sequence","channel","timestamp_us","dominant_frequency","wavelength",
+//          "loudness","rgb":[r,g,b],"lab":[L,a,b],"peaks":[[frequency,magnitude],...]}
+// binary: back-to-back ColourDataMessage packets, as sent by the API server. Colour 0
+//         describes the whole frame (dominant frequency and wavelength, final RGB,
+//         loudness as magnitude); the rest are the peaks, strongest first.
+class FrameStreamer {
+public:
+    explicit FrameStreamer(StreamFormat format, int channelCount = 1, int fd = 1);
+    ~FrameStreamer();
+
+    // The channel's analysis worker thread; channels may capture concurrently
+    void capture(const AnalysisFrame& frame, int channel = 0);
+
+    // Owning thread. Returns false once the reader has gone away.
+    bool flush();
+
+    uint64_t getDroppedRecords() const { return droppedRecords.load(std::memory_order_relaxed); }
+
+private:
+    static constexpr size_t MAX_PENDING_BYTES = 4 * 1024 * 1024;
+
+    StreamFormat format;
+    int channelCount;
+    int fd;
+
+    std::mutex pendingMutex;
+    std::string pending;
+    std::string writing;
+    std::atomic<uint64_t> droppedRecords{0};
+
+    // Worker-owned scratch, one per channel, reused every frame
+    struct Scratch;
+    std::vector<std::unique_ptr<Scratch>> scratch;
+
+    void formatNdjson(const AnalysisFrame& frame, int channel, uint64_t timestamp,
+                      std::string& record);
+    void formatBinary(const AnalysisFrame& frame, int channel, uint64_t timestamp,
+                      Scratch& channelScratch);
+};
+
+}
@@ -4,38 +4,99 @@
 #include <iomanip>
 #include <termios.h>
 #include <unistd.h>
+#include <fcntl.h>
+#include <poll.h>
 #include <csignal>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 #include <thread>
 
-#include "colour_mapper.h"
-
 #ifdef ENABLE_API_SERVER
 #include "api/synesthesia_api_integration.h"
 #endif
 
 namespace CLI {
 
+namespace {
+
+std::string sinceLast(const EventCounter::Clock::time_point when) {
+    if (when.time_since_epoch().count() == 0) {
+        return "";
+    }
+    const auto seconds = std::chrono::duration_cast<std::chrono::seconds>(
+        EventCounter::Clock::now() - when).count();
+    return " (" + std::to_string(seconds) + "s ago)";
+}
+
+}
+
 HeadlessInterface* HeadlessInterface::instance = nullptr;
 
 HeadlessInterface::HeadlessInterface() 
     : running(false), deviceSelected(false), selectedDeviceIndex(-1), apiEnabled(false) {
     instance = this;
     devices = AudioInput::getInputDevices();
+    
+    if (pipe(wakePipe) == 0) {
+        for (const int fd : wakePipe) {
+            fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+        }
+    }
+    audioInput.setFrameListener([this](int, uint64_t) { wake(); });
 }
 
 HeadlessInterface::~HeadlessInterface() {
+    audioInput.setFrameListener(nullptr);
     restoreTerminal();
+    for (const int fd : wakePipe) {
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
     instance = nullptr;
 }
 
 void HeadlessInterface::signalHandler(int /* signal */) {
     if (instance) {
         instance->running = false;
+        instance->wake();
+    }
+}
+
+// Async-signal-safe. A full pipe already guarantees a pending wake-up, so a failed
+// write is fine.
+void HeadlessInterface::wake() {
+    if (wakePipe[1] >= 0) {
+        const char byte = 1;
+        [[maybe_unused]] const auto written = write(wakePipe[1], &byte, 1);
+    }
+}
+
+void HeadlessInterface::waitForEvents(bool& frameReady, bool& keyReady) {
+    pollfd fds[2] = {{STDIN_FILENO, POLLIN, 0}, {wakePipe[0], POLLIN, 0}};
+    if (poll(fds, wakePipe[0] >= 0 ? 2 : 1, wakePipe[0] >= 0 ? -1 : 16) < 0) {
+        return;
+    }
+    
+    keyReady = (fds[0].revents & POLLIN) != 0;
+    if (wakePipe[0] >= 0 && (fds[1].revents & POLLIN) != 0) {
+        char drain[64];
+        while (read(wakePipe[0], drain, sizeof(drain)) > 0) {
+        }
+        frameReady = true;
+    } else if (wakePipe[0] < 0) {
+        frameReady = true;
     }
 }
 
+bool HeadlessInterface::openDevice(const size_t index) {
+    const auto& device = devices[index];
+    return audioInput.initStream(device.paIndex,
+                                 audioInput.isMultichannel() ? device.maxChannels : 1);
+}
+
 void HeadlessInterface::setupTerminal() {
     struct termios term;
     tcgetattr(STDIN_FILENO, &term);
@@ -61,7 +122,11 @@ void HeadlessInterface::restoreTerminal() {
     tcsetattr(STDIN_FILENO, TCSANOW, &term);
 }
 
-void HeadlessInterface::run(bool enableAPI, const std::string& preferredDevice) {
+int HeadlessInterface::run(bool enableAPI, const std::string& preferredDevice) {
+    if (streamFormat != StreamFormat::None) {
+        return runStreaming(enableAPI, preferredDevice);
+    }
+    
     running = true;
     apiEnabled = enableAPI;
     
@@ -73,7 +138,7 @@ void HeadlessInterface::run(bool enableAPI, const std::string& preferredDevice)
             if (devices[i].name.find(preferredDevice) != std::string::npos) {
                 selectedDeviceIndex = static_cast<int>(i);
                 deviceSelected = true;
-                if (audioInput.initStream(devices[i].paIndex)) {
+                if (openDevice(i)) {
                     std::cout << "Using preferred device: " << devices[i].name << std::endl;
                 } else {
                     std::cout << "Failed to initialise preferred device, falling back to selection" << std::endl;
@@ -97,15 +162,26 @@ void HeadlessInterface::run(bool enableAPI, const std::string& preferredDevice)
         selectedDeviceIndex = 0;
     }
     
+    // Sleeps until the worker publishes a frame, a key arrives or a signal fires, and
+    // only touches the terminal when what is on screen would change
+    bool frameReady = true;
     while (running) {
         if (!deviceSelected) {
-            displayDeviceSelection();
-        } else {
+            if (displayDirty) {
+                displayDeviceSelection();
+                displayDirty = false;
+            }
+        } else if (frameReady || displayDirty) {
             displayFrequencyInfo();
+            frameReady = false;
         }
         
-        handleKeypress();
-        std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        bool keyReady = false;
+        waitForEvents(frameReady, keyReady);
+        if (keyReady) {
+            handleKeypress();
+            displayDirty = true;
+        }
     }
     
     std::cout << "\033[?25h\033[2J\033[H";
@@ -118,6 +194,91 @@ void HeadlessInterface::run(bool enableAPI, const std::string& preferredDevice)
 #endif
     
     restoreTerminal();
+    return 0;
+}
+
+// Machine-readable mode: stdout carries only records, everything else goes to stderr,
+// and the terminal is left alone
+int HeadlessInterface::runStreaming(bool enableAPI, const std::string& preferredDevice) {
+    running = true;
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+    std::signal(SIGPIPE, SIG_IGN);
+    
+    if (devices.empty()) {
+        std::cerr << "No audio input devices found" << std::endl;
+        return 1;
+    }
+    
+    size_t deviceIndex = 0;
+    if (!preferredDevice.empty()) {
+        const auto match = std::ranges::find_if(devices, [&](const AudioInput::DeviceInfo& device) {
+            return device.name.find(preferredDevice) != std::string::npos;
+        });
+        if (match == devices.end()) {
+            std::cerr << "No input device matches \"" << preferredDevice << "\"" << std::endl;
+            return 1;
+        }
+        deviceIndex = static_cast<size_t>(match - devices.begin());
+    }
+    
+    // The channel count is only known once the stream is open, so the first frames may
+    // be published before the streamer is listening
+    if (!openDevice(deviceIndex)) {
+        std::cerr << "Failed to open input device " << devices[deviceIndex].name << std::endl;
+        return 1;
+    }
+    const int channels = audioInput.getAnalysedChannelCount();
+    FrameStreamer streamer(streamFormat, channels);
+    audioInput.setFrameListener([this, &streamer](int channel, uint64_t) {
+        streamer.capture(*audioInput.getLatestFrame(channel), channel);
+        wake();
+    });
+    std::cerr << "Streaming from " << devices[deviceIndex].name << " at "
+              << audioInput.getFormat().analysisRate() << " Hz";
+    if (channels > 1) {
+        std::cerr << " (" << channels << " channels)";
+    }
+    std::cerr << std::endl;
+    
+#ifdef ENABLE_API_SERVER
+    if (enableAPI) {
+        Synesthesia::SynesthesiaAPIIntegration::getInstance().startServer();
+    }
+#else
+    (void)enableAPI;
+#endif
+    
+    int exitCode = 0;
+    while (running) {
+        pollfd wakeFd{wakePipe[0], POLLIN, 0};
+        if (wakePipe[0] < 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+        } else if (poll(&wakeFd, 1, -1) > 0) {
+            char drain[64];
+            while (read(wakePipe[0], drain, sizeof(drain)) > 0) {
+            }
+        }
+        
+        if (!streamer.flush()) {
+            exitCode = running ? 1 : 0;
+            break;
+        }
+    }
+    
+    audioInput.setFrameListener([this](int, uint64_t) { wake(); });
+    streamer.flush();
+    
+#ifdef ENABLE_API_SERVER
+    if (enableAPI) {
+        Synesthesia::SynesthesiaAPIIntegration::getInstance().stopServer();
+    }
+#endif
+    
+    if (const uint64_t dropped = streamer.getDroppedRecords(); dropped > 0) {
+        std::cerr << "Dropped " << dropped << " records because the reader fell behind" << std::endl;
+    }
+    return exitCode;
 }
 
 void HeadlessInterface::displayDeviceSelection() {
@@ -158,35 +319,44 @@ void HeadlessInterface::displayDeviceSelection() {
 }
 
 void HeadlessInterface::displayFrequencyInfo() {
-    auto peaks = audioInput.getFrequencyPeaks();
+    const auto frame = audioInput.getLatestFrame();
+    const auto& peaks = frame->peaks;
     
-    float currentDominantFreq = peaks.empty() ? 0.0f : peaks[0].frequency;
+    float currentDominantFreq = frame->dominantFrequency;
     size_t currentPeakCount = peaks.size();
     float currentR = 0.0f, currentG = 0.0f, currentB = 0.0f;
     
     if (!peaks.empty()) {
-        std::vector<float> frequencies, magnitudes;
-        frequencies.reserve(peaks.size());
-        magnitudes.reserve(peaks.size());
-        
-        for (const auto& peak : peaks) {
-            frequencies.push_back(peak.frequency);
-            magnitudes.push_back(peak.magnitude);
+        currentR = frame->colour.r;
+        currentG = frame->colour.g;
+        currentB = frame->colour.b;
+    }
+    
+    const auto captureStats = audioInput.getCaptureStats();
+    const uint64_t lossEvents = captureStats.droppedBuffers.count + captureStats.mergedBuffers.count +
+                                captureStats.truncatedSamples.count + captureStats.inputOverflows.count +
+                                captureStats.inputUnderflows.count;
+    
+    const int channels = audioInput.getAnalysedChannelCount();
+    bool channelsChanged = lastChannelFreqs.size() != static_cast<size_t>(channels);
+    lastChannelFreqs.resize(static_cast<size_t>(channels), -1.0f);
+    if (channels > 1) {
+        for (int channel = 0; channel < channels; ++channel) {
+            const float freq = audioInput.getLatestFrame(channel)->dominantFrequency;
+            float& last = lastChannelFreqs[static_cast<size_t>(channel)];
+            if (std::abs(freq - last) > 0.1f) {
+                channelsChanged = true;
+                last = freq;
+            }
         }
-        
-        auto colourResult = ColourMapper::frequenciesToColour(
-            frequencies, magnitudes, {}, 44100.0f, 2.2f, true);
-        
-        currentR = colourResult.r;
-        currentG = colourResult.g;
-        currentB = colourResult.b;
     }
     
-    bool needsRedraw = (abs(currentDominantFreq - lastDominantFreq) > 0.1f) ||
+    bool needsRedraw = displayDirty || channelsChanged || (lossEvents != lastLossEvents) ||
+                       (std::abs(currentDominantFreq - lastDominantFreq) > 0.1f) ||
                        (currentPeakCount != lastPeakCount) ||
-                       (abs(currentR - lastR) > 0.001f) ||
-                       (abs(currentG - lastG) > 0.001f) ||
-                       (abs(currentB - lastB) > 0.001f);
+                       (std::abs(currentR - lastR) > 0.001f) ||
+                       (std::abs(currentG - lastG) > 0.001f) ||
+                       (std::abs(currentB - lastB) > 0.001f);
     
     if (needsRedraw) {
         std::cout << "\033[2J\033[H";
@@ -200,6 +370,12 @@ void HeadlessInterface::displayFrequencyInfo() {
             std::cout << "Total Peaks: " << currentPeakCount << "\n";
             std::cout << std::setprecision(3);
             std::cout << "RGB: (" << currentR << ", " << currentG << ", " << currentB << ")\n";
+            const auto latency = audioInput.getLatencyStats();
+            std::cout << std::setprecision(1);
+            std::cout << "Latency: " << latency.total.lastMs << " ms (queue "
+                      << latency.queue.lastMs << ", FFT " << latency.analysis.lastMs
+                      << ", colour " << latency.colour.lastMs << ", max "
+                      << latency.total.maxMs << ")\n";
         } else {
             std::cout << "Dominant Frequency: -- Hz\n";
             std::cout << "Total Peaks: 0\n";
@@ -207,6 +383,29 @@ void HeadlessInterface::displayFrequencyInfo() {
             std::cout << "\n(No significant frequencies detected)\n";
         }
         
+        if (channels > 1) {
+            std::cout << "\n" << std::fixed;
+            for (int channel = 0; channel < channels; ++channel) {
+                const auto channelFrame = audioInput.getLatestFrame(channel);
+                std::cout << "Channel " << channel + 1 << ": ";
+                if (channelFrame->peaks.empty()) {
+                    std::cout << "-- Hz\n";
+                    continue;
+                }
+                const auto& colour = channelFrame->colour;
+                std::cout << std::setprecision(1) << channelFrame->dominantFrequency << " Hz | RGB ("
+                          << std::setprecision(3) << colour.r << ", " << colour.g << ", "
+                          << colour.b << ")\n";
+            }
+        }
+        
+        std::cout << "Dropped: " << captureStats.droppedBuffers.count
+                  << sinceLast(captureStats.droppedBuffers.lastOccurrence)
+                  << " | Merged: " << captureStats.mergedBuffers.count
+                  << " | Truncated: " << captureStats.truncatedSamples.count << " samples"
+                  << " | Overflows: " << captureStats.inputOverflows.count
+                  << sinceLast(captureStats.inputOverflows.lastOccurrence) << "\n";
+        
 #ifdef ENABLE_API_SERVER
         if (apiEnabled) {
             auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
@@ -229,7 +428,17 @@ void HeadlessInterface::displayFrequencyInfo() {
         lastR = currentR;
         lastG = currentG;
         lastB = currentB;
+        lastLossEvents = lossEvents;
+        displayDirty = false;
+    }
+    
+#ifdef ENABLE_API_SERVER
+    if (apiEnabled) {
+        auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
+        api.updateCaptureStats(captureStats);
+        api.updateSpectralFeatures(frame->features, frame->captureTime);
     }
+#endif
 }
 
 void HeadlessInterface::handleKeypress() {
@@ -254,7 +463,7 @@ void HeadlessInterface::handleKeypress() {
                 }
             } else if (ch == '\n' || ch == '\r') {
                 if (selectedDeviceIndex >= 0 && selectedDeviceIndex < static_cast<int>(devices.size())) {
-                    if (audioInput.initStream(devices[static_cast<size_t>(selectedDeviceIndex)].paIndex)) {
+                    if (openDevice(static_cast<size_t>(selectedDeviceIndex))) {
                         deviceSelected = true;
                     }
                 }
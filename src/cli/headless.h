@@ -7,6 +7,7 @@
 
 #include "audio_input.h"
 #include "fft_processor.h"
+#include "frame_stream.h"
 
 namespace CLI {
 
@@ -15,7 +16,19 @@ public:
     HeadlessInterface();
     ~HeadlessInterface();
     
-    void run(bool enableAPI = false, const std::string& preferredDevice = "");
+    // Returns the process exit code
+    int run(bool enableAPI = false, const std::string& preferredDevice = "");
+    void setOverflowPolicy(AudioProcessor::OverflowPolicy policy) { audioInput.setOverflowPolicy(policy); }
+    void setNoiseFloorMode(FFTProcessor::NoiseFloorMode mode) { audioInput.getFFTProcessor().setNoiseFloorMode(mode); }
+    void setPeakInterpolation(FFTProcessor::PeakInterpolation method) { audioInput.getFFTProcessor().setPeakInterpolation(method); }
+    void setMultiResolution(bool enabled) { audioInput.getFFTProcessor().setMultiResolution(enabled); }
+    void setFFTBackend(FFTBackend::Kind kind) { audioInput.getFFTProcessor().setFFTBackend(kind); }
+    void setCaptureConfig(const AudioInput::CaptureConfig& config) { audioInput.setCaptureConfig(config); }
+    void setHopSize(size_t samples) { audioInput.setHopSize(samples); }
+    void setStreamFormat(StreamFormat format) { streamFormat = format; }
+    // Analyse every input channel: one record per channel per frame when streaming, and a
+    // line per channel on screen
+    void setMultichannel(bool enabled) { audioInput.setMultichannel(enabled); }
     
 private:
     std::atomic<bool> running;
@@ -25,17 +38,27 @@ private:
     
     std::vector<AudioInput::DeviceInfo> devices;
     AudioInput audioInput;
+    StreamFormat streamFormat = StreamFormat::None;
+    
+    // Self-pipe: the analysis worker and the signal handler write a byte to wake run()
+    int wakePipe[2] = {-1, -1};
+    bool displayDirty = true;
     
     float lastDominantFreq = -1.0f;
     size_t lastPeakCount = 0;
     float lastR = -1.0f, lastG = -1.0f, lastB = -1.0f;
+    uint64_t lastLossEvents = 0;
+    std::vector<float> lastChannelFreqs;  // multichannel mode, per channel
     
     void setupTerminal();
     void restoreTerminal();
     void displayDeviceSelection();
     void displayFrequencyInfo();
     void handleKeypress();
-    void processAudioLoop();
+    bool openDevice(size_t index);
+    void waitForEvents(bool& frameReady, bool& keyReady);
+    int runStreaming(bool enableAPI, const std::string& preferredDevice);
+    void wake();
     
     static void signalHandler(int signal);
     static HeadlessInterface* instance;
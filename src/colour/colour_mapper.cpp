@@ -1,4 +1,6 @@
 #include "colour_mapper.h"
+#include "envelope_colour_mapper.h"
+#include "fast_math.h"
 
 #include <algorithm>
 #include <array>
@@ -244,10 +246,10 @@ ColourMapper::SpectralCharacteristics ColourMapper::calculateSpectralCharacteris
 	if (!validValues.empty() && totalWeight > 0.0f) {
 		float logSum = 0.0f;
 		for (const float value : validValues) {
-			logSum += std::log(value);
+			logSum += FastMath::log(value);
 		}
 
-		const float geometricMean = std::exp(logSum / validValues.size());
+		const float geometricMean = FastMath::exp(logSum / validValues.size());
 
 		if (const float arithmeticMean = totalWeight / validValues.size();
 			arithmeticMean > 1e-10f) {
@@ -299,7 +301,9 @@ ColourMapper::ColourResult ColourMapper::frequenciesToColour(
 
 	if (hasPeaks) {
 		size_t count = std::min(frequencies.size(), magnitudes.size());
-		std::vector weights(count, 0.0f);
+		// Thread-local like the other scratch buffers here, so steady-state frames reuse capacity
+		thread_local static std::vector<float> weights;
+		weights.assign(count, 0.0f);
 
 		size_t validCount = 0;
 		float maxValidMagnitude = 0.0f;
@@ -340,12 +344,14 @@ ColourMapper::ColourResult ColourMapper::frequenciesToColour(
 				float b_blend = 0.0f;
 				float dominantWavelength = logFrequencyToWavelength(maxFrequency);
 
-				std::vector<float> validFrequencies;
-				std::vector<float> normalisedWeights;
-				std::vector<float> wavelengths;
-				std::vector<float> r_values, g_values, b_values;
-				std::vector<float> L_values, a_values, b_comp_values;
+				thread_local static std::vector<float> validFrequencies;
+				thread_local static std::vector<float> normalisedWeights;
+				thread_local static std::vector<float> wavelengths;
+				thread_local static std::vector<float> r_values, g_values, b_values;
+				thread_local static std::vector<float> L_values, a_values, b_comp_values;
 				
+				validFrequencies.clear();
+				normalisedWeights.clear();
 				validFrequencies.reserve(count);
 				normalisedWeights.reserve(count);
 				
@@ -433,106 +439,10 @@ ColourMapper::ColourResult ColourMapper::frequenciesToColour(
 	
 	SpectralCharacteristics spectralStats{SPECTRAL_FLATNESS_WEIGHT, 0.0f, 0.0f, 0.0f};
 	if (hasEnvelope) {
-		spectralStats = calculateSpectralCharacteristics(spectralEnvelope, sampleRate);
-	}
-
-	if (hasEnvelope) {
-		const size_t binCount = spectralEnvelope.size();
-
-		std::vector<float> envelopeFrequencies;
-		std::vector<float> envelopeWeights;
-		envelopeFrequencies.reserve(binCount);
-		envelopeWeights.reserve(binCount);
-
-		float totalEnvelopeWeight = 0.0f;
-		float maxEnvelopeWeight = 0.0f;
-		float dominantEnvelopeFreq = 0.0f;
-
-		for (size_t i = 0; i < binCount; ++i) {
-			float freq = binCount <= 1 ? 0.0f : 
-				static_cast<float>(i) * sampleRate / (2.0f * (binCount - 1));
-
-			if (freq < MIN_FREQ || freq > MAX_FREQ || !std::isfinite(freq)) {
-				continue;
-			}
-
-			float weight = spectralEnvelope[i];
-			if (!std::isfinite(weight) || weight <= 0.0f) {
-				continue;
-			}
-
-			float perceptualWeight = weight;
-
-			envelopeFrequencies.push_back(freq);
-			envelopeWeights.push_back(perceptualWeight);
-
-			totalEnvelopeWeight += perceptualWeight;
-
-			if (perceptualWeight > maxEnvelopeWeight) {
-				maxEnvelopeWeight = perceptualWeight;
-				dominantEnvelopeFreq = freq;
-			}
-		}
-
-		if (!envelopeFrequencies.empty() && totalEnvelopeWeight > 0.0f) {
-			float spectralCentroid = spectralStats.centroid;
-			float spectralFlatness = spectralStats.flatness;
-			float normalisedSpread = spectralStats.normalisedSpread;
-
-			for (float& envelopeWeight : envelopeWeights) {
-				envelopeWeight /= totalEnvelopeWeight;
-			}
-
-			float L_envelope = 0.0f;
-			float a_envelope = 0.0f;
-			float b_envelope = 0.0f;
-			float dominantWavelength = logFrequencyToWavelength(dominantEnvelopeFreq);
-
-			for (size_t i = 0; i < envelopeFrequencies.size(); ++i) {
-				float weight = envelopeWeights[i];
-				if (weight <= 0.0f)
-					continue;
-
-				float wavelength = logFrequencyToWavelength(envelopeFrequencies[i]);
-
-				float r, g, b;
-				wavelengthToRGBCIE(wavelength, r, g, b, useP3);
-
-				float L, a, b_comp;
-				RGBtoLab(r, g, b, L, a, b_comp);
-
-				float saturationFactor =
-					(1.0f - spectralFlatness) * (1.0f - 0.5f * normalisedSpread);
-				float saturationBoost = 1.0f + saturationFactor;
-
-				a *= saturationBoost;
-				b_comp *= saturationBoost;
-
-				float centroidFactor = std::clamp(
-					std::log2(spectralCentroid / MIN_FREQ) / std::log2(MAX_FREQ / MIN_FREQ), 0.0f,
-					1.0f);
-
-				float contrastBoost = 1.0f + normalisedSpread * 0.5f;
-				float brightnessAdjust = centroidFactor * contrastBoost;
-
-				L = std::lerp(L, std::min(L * 1.2f, 100.0f), brightnessAdjust);
-
-				L_envelope += L * weight;
-				a_envelope += a * weight;
-				b_envelope += b_comp * weight;
-			}
-
-			LabtoRGB(L_envelope, a_envelope, b_envelope, envelopeResult.r, envelopeResult.g,
-					 envelopeResult.b);
-
-			envelopeResult.dominantWavelength = dominantWavelength;
-			envelopeResult.dominantFrequency = dominantEnvelopeFreq;
-			envelopeResult.L = L_envelope;
-			envelopeResult.a = a_envelope;
-			envelopeResult.b_comp = b_envelope;
-
-			hasEnvelopeColour = true;
-		}
+		// Tables are rebuilt only when the sample rate, bin count or gamut change
+		thread_local EnvelopeColourMapper envelopeMapper;
+		hasEnvelopeColour = envelopeMapper.map(spectralEnvelope, sampleRate, useP3,
+											   envelopeResult, spectralStats);
 	}
 
 	if (hasPeakColour && hasEnvelopeColour) {
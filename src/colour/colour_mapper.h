@@ -59,6 +59,8 @@ public:
 		const std::vector<float>& spectrum, float sampleRate);
 
 private:
+	friend class EnvelopeColourMapper;
+
 	static bool isValidFrequencyMagnitudePair(float frequency, float magnitude) {
 		return std::isfinite(frequency) && std::isfinite(magnitude) &&
 		       frequency > 0.0f && magnitude >= 0.0f;
@@ -0,0 +1,154 @@
+#include "envelope_colour_mapper.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fast_math.h"
+
+void EnvelopeColourMapper::prepare(const size_t binCount, const float sampleRate, const bool useP3) {
+	if (binCount == preparedBinCount && sampleRate == preparedSampleRate && useP3 == preparedP3) {
+		return;
+	}
+
+	preparedBinCount = binCount;
+	preparedSampleRate = sampleRate;
+	preparedP3 = useP3;
+
+	binFrequency.clear();
+	binL.clear();
+	binLBrightened.clear();
+	binA.clear();
+	binB.clear();
+	firstBin = binCount;
+
+	if (binCount <= 1 || sampleRate <= 0.0f) {
+		return;
+	}
+
+	for (size_t i = 0; i < binCount; ++i) {
+		const float freq =
+			static_cast<float>(i) * sampleRate / (2.0f * static_cast<float>(binCount - 1));
+		if (freq < ColourMapper::MIN_FREQ) {
+			continue;
+		}
+		if (freq > ColourMapper::MAX_FREQ) {
+			break;
+		}
+		if (binFrequency.empty()) {
+			firstBin = i;
+		}
+
+		float r, g, b;
+		ColourMapper::wavelengthToRGBCIE(ColourMapper::logFrequencyToWavelength(freq), r, g, b,
+										 useP3);
+
+		float L, a, b_comp;
+		ColourMapper::RGBtoLab(r, g, b, L, a, b_comp);
+
+		binFrequency.push_back(freq);
+		binL.push_back(L);
+		binLBrightened.push_back(std::min(L * 1.2f, 100.0f) - L);
+		binA.push_back(a);
+		binB.push_back(b_comp);
+	}
+}
+
+bool EnvelopeColourMapper::map(const std::span<const float> envelope, const float sampleRate,
+							   const bool useP3, ColourMapper::ColourResult& result,
+							   ColourMapper::SpectralCharacteristics& stats) {
+	stats = {0.5f, 0.0f, 0.0f, 0.0f};
+	prepare(envelope.size(), sampleRate, useP3);
+
+	const size_t count = binFrequency.size();
+	if (count == 0) {
+		return false;
+	}
+
+	const float* values = envelope.data() + firstBin;
+	const float* freqs = binFrequency.data();
+
+	// Colour weights take any positive bin; the statistics ignore bins below 1e-6, as
+	// ColourMapper::calculateSpectralCharacteristics does
+	float colourWeight = 0.0f;
+	float sumL = 0.0f;
+	float sumBrightened = 0.0f;
+	float sumA = 0.0f;
+	float sumB = 0.0f;
+	float statsWeight = 0.0f;
+	float statsFreq = 0.0f;
+	float statsCount = 0.0f;
+	float logSum = 0.0f;
+
+	for (size_t k = 0; k < count; ++k) {
+		const float value = values[k];
+		const float weight = value > 0.0f && std::isfinite(value) ? value : 0.0f;
+		const float statsValue = weight > 1e-6f ? weight : 0.0f;
+		const float present = statsValue > 0.0f ? 1.0f : 0.0f;
+
+		colourWeight += weight;
+		sumL += weight * binL[k];
+		sumBrightened += weight * binLBrightened[k];
+		sumA += weight * binA[k];
+		sumB += weight * binB[k];
+
+		statsWeight += statsValue;
+		statsFreq += statsValue * freqs[k];
+		statsCount += present;
+		logSum += present * FastMath::log(std::max(statsValue, 1e-6f));
+	}
+
+	if (statsCount > 0.0f && statsWeight > 0.0f) {
+		stats.centroid = statsFreq / statsWeight;
+
+		const float geometricMean = FastMath::exp(logSum / statsCount);
+		if (const float arithmeticMean = statsWeight / statsCount; arithmeticMean > 1e-10f) {
+			stats.flatness = geometricMean / arithmeticMean;
+		}
+	}
+
+	float spreadSum = 0.0f;
+	float maxWeight = 0.0f;
+	float dominantFreq = 0.0f;
+	for (size_t k = 0; k < count; ++k) {
+		const float value = values[k];
+		const float statsValue = value > 1e-6f && std::isfinite(value) ? value : 0.0f;
+		const float diff = freqs[k] - stats.centroid;
+		spreadSum += statsValue * diff * diff;
+
+		if (value > maxWeight && std::isfinite(value)) {
+			maxWeight = value;
+			dominantFreq = freqs[k];
+		}
+	}
+
+	if (statsWeight > 0.0f) {
+		stats.spread = std::sqrt(spreadSum / statsWeight);
+		stats.normalisedSpread =
+			std::min(stats.spread / ColourMapper::SPREAD_NORMALISATION, 1.0f);
+	}
+
+	if (colourWeight <= 0.0f) {
+		return false;
+	}
+
+	// The saturation and brightness adjustments only depend on frame-wide statistics,
+	// so they scale the sums instead of every bin
+	const float saturationBoost =
+		1.0f + (1.0f - stats.flatness) * (1.0f - 0.5f * stats.normalisedSpread);
+	const float centroidFactor =
+		stats.centroid > ColourMapper::MIN_FREQ
+			? std::clamp(std::log2(stats.centroid / ColourMapper::MIN_FREQ) /
+							 std::log2(ColourMapper::MAX_FREQ / ColourMapper::MIN_FREQ),
+						 0.0f, 1.0f)
+			: 0.0f;
+	const float brightnessAdjust = centroidFactor * (1.0f + stats.normalisedSpread * 0.5f);
+
+	result.L = (sumL + brightnessAdjust * sumBrightened) / colourWeight;
+	result.a = saturationBoost * sumA / colourWeight;
+	result.b_comp = saturationBoost * sumB / colourWeight;
+	ColourMapper::LabtoRGB(result.L, result.a, result.b_comp, result.r, result.g, result.b);
+
+	result.dominantFrequency = dominantFreq;
+	result.dominantWavelength = ColourMapper::logFrequencyToWavelength(dominantFreq);
+	return true;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include "colour_mapper.h"
+
+// Maps a spectral envelope to a colour in one pass. The per-bin Lab colours depend
+// only on the bin frequency and gamut, so they are tabulated once per sample rate,
+// bin count and gamut; each frame then reduces to weighted sums over the tables.
+class EnvelopeColourMapper {
+public:
+	// Rebuilds the tables if any of the parameters changed since the last call
+	void prepare(size_t binCount, float sampleRate, bool useP3);
+
+	// Fills result (r, g, b, L, a, b_comp and the dominant frequency/wavelength) and the
+	// envelope's spectral statistics. Returns false when no in-range bin carries energy,
+	// in which case only stats is meaningful.
+	bool map(std::span<const float> envelope, float sampleRate, bool useP3,
+			 ColourMapper::ColourResult& result, ColourMapper::SpectralCharacteristics& stats);
+
+private:
+	size_t preparedBinCount = 0;
+	float preparedSampleRate = 0.0f;
+	bool preparedP3 = true;
+
+	size_t firstBin = 0;	// first bin at or above ColourMapper::MIN_FREQ
+	std::vector<float> binFrequency;	// tables cover the bins inside [MIN_FREQ, MAX_FREQ]
+	std::vector<float> binL;
+	std::vector<float> binLBrightened;	// min(1.2 L, 100) - L, scaled per frame by centroid
+	std::vector<float> binA;
+	std::vector<float> binB;
+};
@@ -0,0 +1,38 @@
+#include "cli/cli.h"
+#include "cli/daemon.h"
+#include "metrics/metrics_endpoint.h"
+
+#include <iostream>
+
+int main(int argc, char* argv[]) {
+    const CLI::Arguments args = CLI::Arguments::parseCommandLine(argc, argv);
+
+    if (args.showHelp) {
+        CLI::Arguments::printDaemonHelp();
+        return 0;
+    }
+
+    if (args.showVersion) {
+        CLI::Arguments::printVersion();
+        return 0;
+    }
+
+    try {
+        if (args.listDevices) {
+            CLI::Daemon::listDevices();
+            return 0;
+        }
+
+        Metrics::MetricsEndpoint metricsEndpoint(args.metricsSocket);
+        if (!args.metricsSocket.empty() && !metricsEndpoint.start()) {
+            std::cerr << "Failed to start metrics endpoint on " << args.metricsSocket << ": "
+                      << metricsEndpoint.getError() << std::endl;
+        }
+
+        CLI::Daemon daemon;
+        return daemon.run(args);
+    } catch (const std::exception& e) {
+        std::cerr << "Fatal: " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+// Polynomial log2/exp2 for the per-bin feature passes. Branch-free and header-only so
+// loops calling them still vectorise. Building with USE_FAST_MATH_KERNELS switches
+// FastMath::log/exp/log10 over to them; otherwise those forward to <cmath>.
+namespace FastMath {
+
+// Within 3 ulp of log2(x) for any positive, normal x (absolute error below 1.1e-7 for
+// x in [0.5, 2]). Zero, negative, denormal and non-finite inputs are not handled;
+// callers clamp first.
+inline float log2Approx(const float x) {
+	constexpr float SQRT_TWO = 1.41421356f;
+
+	// x = m * 2^e with m in [sqrt(1/2), sqrt(2)), so the series argument stays small
+	const auto bits = std::bit_cast<uint32_t>(x);
+	auto exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 127);
+	float mantissa = std::bit_cast<float>((bits & 0x007FFFFFu) | 0x3F800000u);
+	const bool high = mantissa > SQRT_TWO;
+	mantissa = high ? mantissa * 0.5f : mantissa;
+	exponent = high ? exponent + 1.0f : exponent;
+
+	// log2(m) = 2/ln2 * atanh(t), t = (m - 1) / (m + 1), |t| < 0.172
+	const float t = (mantissa - 1.0f) / (mantissa + 1.0f);
+	const float t2 = t * t;
+	const float series =
+		t * (2.8853900f + t2 * (0.9617967f + t2 * (0.5770780f + t2 * (0.4121986f + t2 * 0.3205990f))));
+	return exponent + series;
+}
+
+// Relative error below 3e-7 for x in [-126, 127]; the input is clamped to that range
+inline float exp2Approx(float x) {
+	x = std::fmin(std::fmax(x, -126.0f), 127.0f);
+
+	// 2^x = 2^n * 2^f with n = round(x), f in [-0.5, 0.5]
+	const float n = std::nearbyint(x);
+	const float f = (x - n) * 0.69314718f;
+	const float poly =
+		1.0f + f * (1.0f + f * (0.5f + f * (1.6666667e-1f +
+			f * (4.1666668e-2f + f * (8.3333338e-3f + f * 1.3888889e-3f)))));
+	const auto scale = std::bit_cast<float>(static_cast<uint32_t>(static_cast<int32_t>(n) + 127) << 23);
+	return poly * scale;
+}
+
+inline float log(const float x) {
+#ifdef USE_FAST_MATH_KERNELS
+	return log2Approx(x) * 0.69314718f;
+#else
+	return std::log(x);
+#endif
+}
+
+inline float log10(const float x) {
+#ifdef USE_FAST_MATH_KERNELS
+	return log2Approx(x) * 0.30103000f;
+#else
+	return std::log10(x);
+#endif
+}
+
+inline float log2(const float x) {
+#ifdef USE_FAST_MATH_KERNELS
+	return log2Approx(x);
+#else
+	return std::log2(x);
+#endif
+}
+
+inline float exp(const float x) {
+#ifdef USE_FAST_MATH_KERNELS
+	return exp2Approx(x * 1.44269504f);
+#else
+	return std::exp(x);
+#endif
+}
+
+}
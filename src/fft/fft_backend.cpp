@@ -0,0 +1,80 @@
+#include "fft_backend.h"
+
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+#include "kiss_fftr.h"
+
+#ifdef USE_FFTW_BACKEND
+#include "fftw_backend.h"
+#endif
+
+static_assert(sizeof(FFTComplex) == sizeof(kiss_fft_cpx) &&
+				  offsetof(kiss_fft_cpx, r) == offsetof(FFTComplex, r) &&
+				  offsetof(kiss_fft_cpx, i) == offsetof(FFTComplex, i),
+			  "FFTComplex must match kiss_fft_cpx so kissfft can write into it directly");
+
+namespace {
+
+class KissFFTBackend final : public FFTBackend {
+public:
+	explicit KissFFTBackend(const int size)
+		: FFTBackend(Kind::KissFFT, size), config(kiss_fftr_alloc(size, 0, nullptr, nullptr)) {
+		if (!config) {
+			throw std::runtime_error("Error allocating FFTR configuration.");
+		}
+	}
+
+	~KissFFTBackend() override { kiss_fftr_free(config); }
+
+	KissFFTBackend(const KissFFTBackend&) = delete;
+	KissFFTBackend& operator=(const KissFFTBackend&) = delete;
+
+	void forward(const std::span<const float> input, const std::span<FFTComplex> output) override {
+		kiss_fftr(config, input.data(), reinterpret_cast<kiss_fft_cpx*>(output.data()));
+	}
+
+private:
+	kiss_fftr_cfg config;
+};
+
+}
+
+std::unique_ptr<FFTBackend> FFTBackend::create(const Kind kind, const int size) {
+	switch (kind) {
+		case Kind::KissFFT:
+			return std::make_unique<KissFFTBackend>(size);
+		case Kind::FFTW:
+#ifdef USE_FFTW_BACKEND
+			return std::make_unique<FFTWBackend>(size);
+#else
+			break;
+#endif
+	}
+	throw std::runtime_error(std::string("FFT backend not built: ") + name(kind));
+}
+
+bool FFTBackend::isAvailable(const Kind kind) {
+	switch (kind) {
+		case Kind::KissFFT:
+			return true;
+		case Kind::FFTW:
+#ifdef USE_FFTW_BACKEND
+			return true;
+#else
+			return false;
+#endif
+	}
+	return false;
+}
+
+const char* FFTBackend::name(const Kind kind) {
+	switch (kind) {
+		case Kind::KissFFT:
+			return "kissfft";
+		case Kind::FFTW:
+			return "fftw";
+	}
+	return "unknown";
+}
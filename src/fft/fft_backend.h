@@ -0,0 +1,44 @@
+#pragma once
+
+#include <memory>
+#include <span>
+
+// One complex FFT bin. Laid out like kiss_fft_cpx and fftwf_complex so backends can hand
+// their output over without converting it.
+struct FFTComplex {
+	float r;
+	float i;
+};
+
+// Forward real-to-complex transform of a fixed size. Output holds size/2 + 1 bins, DC
+// first, unscaled, with the e^(-i) sign convention; every backend produces the same
+// layout and scale so the analysis above them does not know which one it has.
+//
+// A backend instance is not safe to use from two threads at once.
+class FFTBackend {
+public:
+	enum class Kind {
+		KissFFT, // portable, always built
+		FFTW	 // FFTW3 single precision, with ENABLE_FFTW_BACKEND
+	};
+
+	virtual ~FFTBackend() = default;
+
+	// Throws std::runtime_error if the backend is not built in or cannot plan this size
+	static std::unique_ptr<FFTBackend> create(Kind kind, int size);
+	static bool isAvailable(Kind kind);
+	static const char* name(Kind kind);
+
+	// input holds size() samples and output size() / 2 + 1 bins; they must not overlap
+	virtual void forward(std::span<const float> input, std::span<FFTComplex> output) = 0;
+
+	int size() const { return transformSize; }
+	Kind kind() const { return backendKind; }
+
+protected:
+	FFTBackend(Kind kind, int size) : backendKind(kind), transformSize(size) {}
+
+private:
+	Kind backendKind;
+	int transformSize;
+};
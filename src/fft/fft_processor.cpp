@@ -4,27 +4,39 @@
 #include <chrono>
 #include <cmath>
 #include <numeric>
-#include <stdexcept>
+
+#include "fast_math.h"
 
 #ifndef M_PI
 #define M_PI 3.14159265358979323846
 #endif
 
 FFTProcessor::FFTProcessor()
-	: fft_in(FFT_SIZE),
+	: fftBackend(FFTBackend::create(FFTBackend::Kind::KissFFT, FFT_SIZE)),
+	  fft_in(FFT_SIZE),
 	  fft_out(FFT_SIZE / 2 + 1),
 	  hannWindow(FFT_SIZE),
 	  magnitudesBuffer(FFT_SIZE / 2 + 1, 0.0f),
 	  spectralEnvelope(FFT_SIZE / 2 + 1, 0.0f),
+	  rawMagnitudesBuffer(FFT_SIZE / 2 + 1, 0.0f),
+	  previousSpectrum(FFT_SIZE / 2 + 1),
+	  lowBandMagnitudes(LowBandAnalyser::FFT_SIZE / 2 + 1, 0.0f),
 	  lastValidPeakTime(std::chrono::steady_clock::now()),
 	  lowGain(1.0f),
 	  midGain(1.0f),
 	  highGain(1.0f),
-	  currentLoudness(0.0f) {
-	fft_cfg = kiss_fftr_alloc(FFT_SIZE, 0, nullptr, nullptr);
-	if (!fft_cfg) {
-		throw std::runtime_error("Error allocating FFTR configuration.");
-	}
+	  currentLoudness(0.0f),
+	  processDuration(Metrics::Registry::instance().histogram(
+		  "synesthesia_fft_duration_seconds",
+		  "Time spent transforming one buffer and extracting its peaks",
+		  Metrics::latencyBucketsSeconds())),
+	  binGains(FFT_SIZE / 2 + 1, 0.0f),
+	  envelopeWeights(FFT_SIZE / 2 + 1, 0.0f),
+	  lowBandGains(LowBandAnalyser::FFT_SIZE / 2 + 1, 0.0f) {
+	currentPeaks.reserve(MAX_PEAKS);
+	retainedPeaks.reserve(MAX_PEAKS);
+	framePeaks.reserve(MAX_PEAKS);
+	candidatePeaksBuffer.reserve(FFT_SIZE / 2 + 1);
 
 	for (size_t i = 0; i < hannWindow.size(); ++i) {
 		hannWindow[i] =
@@ -32,10 +44,32 @@ FFTProcessor::FFTProcessor()
 	}
 }
 
-FFTProcessor::~FFTProcessor() {
-	if (fft_cfg) {
-		kiss_fftr_free(fft_cfg);
-		fft_cfg = nullptr;
+void FFTProcessor::setFFTBackend(const FFTBackend::Kind kind) {
+	auto mainBackend = FFTBackend::create(kind, FFT_SIZE);
+	auto lowBandBackend = FFTBackend::create(kind, LowBandAnalyser::FFT_SIZE);
+
+	std::lock_guard processingLock(processingMutex);
+	fftBackend = std::move(mainBackend);
+	lowBand.setBackend(std::move(lowBandBackend));
+}
+
+FFTBackend::Kind FFTProcessor::getFFTBackend() const {
+	std::lock_guard processingLock(processingMutex);
+	return fftBackend->kind();
+}
+
+void FFTProcessor::copySettings(const FFTProcessor& other) {
+	if (&other == this) {
+		return;
+	}
+
+	const BandGains gains = other.readGains();
+	setEQGains(gains.low, gains.mid, gains.high);
+	setNoiseFloorMode(other.getNoiseFloorMode());
+	setPeakInterpolation(other.getPeakInterpolation());
+	setMultiResolution(other.isMultiResolution());
+	if (const FFTBackend::Kind kind = other.getFFTBackend(); kind != getFFTBackend()) {
+		setFFTBackend(kind);
 	}
 }
 
@@ -44,6 +78,11 @@ float FFTProcessor::getCurrentLoudness() const {
 	return currentLoudness;
 }
 
+SpectralFeatures FFTProcessor::getSpectralFeatures() const {
+	std::lock_guard lock(peaksMutex);
+	return currentFeatures;
+}
+
 void FFTProcessor::setEQGains(const float low, const float mid, const float high) {
 	std::lock_guard lock(gainsMutex);
 	lowGain = std::max(0.0f, low);
@@ -71,13 +110,21 @@ void FFTProcessor::applyWindow(const std::span<const float> buffer) {
 	}
 }
 
-void FFTProcessor::processBuffer(const std::span<const float> buffer, const float sampleRate) {
+void FFTProcessor::processBuffer(const std::span<const float> buffer, const float sampleRate,
+								 const std::chrono::steady_clock::time_point frameTime) {
+	processWindow(buffer, buffer.size(), sampleRate, frameTime);
+}
+
+void FFTProcessor::processWindow(const std::span<const float> buffer, const size_t newSamples,
+								 const float sampleRate,
+								 const std::chrono::steady_clock::time_point frameTime) {
 	if (sampleRate <= 0.0f || buffer.empty())
 		return;
 	std::lock_guard processingLock(processingMutex);
+	const auto startTime = std::chrono::steady_clock::now();
 
 	applyWindow(buffer);
-	kiss_fftr(fft_cfg, fft_in.data(), fft_out.data());
+	fftBackend->forward(fft_in, fft_out);
 
 	constexpr float scaleFactor = 2.0f / FFT_SIZE;
 	for (auto& i : fft_out) {
@@ -91,7 +138,26 @@ void FFTProcessor::processBuffer(const std::span<const float> buffer, const floa
 		fft_out[fft_out.size() - 1].i *= 0.5f;
 	}
 
-	findFrequencyPeaks(sampleRate);
+	// Windows are assumed to end where the previous one did plus newSamples, so the hop the
+	// phase vocoder measures over is how far the window's start moved
+	const size_t startShift = previousBufferSize + newSamples;
+	phaseHop = sampleRate == previousSampleRate && startShift > buffer.size()
+				   ? startShift - buffer.size()
+				   : 0;
+
+	if (sampleRate != previousSampleRate) {
+		lowBand.reset();
+	}
+	lowBand.push(buffer.last(std::min(newSamples, buffer.size())));
+
+	findFrequencyPeaks(sampleRate, frameTime);
+
+	std::ranges::copy(fft_out, previousSpectrum.begin());
+	previousBufferSize = buffer.size();
+	previousSampleRate = sampleRate;
+
+	processDuration.observe(
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
 }
 
 std::vector<FFTProcessor::FrequencyPeak> FFTProcessor::getDominantFrequencies() const {
@@ -103,6 +169,22 @@ std::vector<FFTProcessor::FrequencyPeak> FFTProcessor::getDominantFrequencies()
 	return currentPeaks;
 }
 
+void FFTProcessor::copyResults(std::vector<FrequencyPeak>& peaks, std::vector<float>& magnitudes,
+							   std::vector<float>& envelope, float& loudness,
+							   SpectralFeatures& features) const {
+	std::lock_guard lock(peaksMutex);
+
+	if (currentPeaks.empty() || currentPeaks[0].magnitude < 0.01f) {
+		peaks.clear();
+	} else {
+		peaks.assign(currentPeaks.begin(), currentPeaks.end());
+	}
+	magnitudes.assign(magnitudesBuffer.begin(), magnitudesBuffer.end());
+	envelope.assign(spectralEnvelope.begin(), spectralEnvelope.end());
+	loudness = currentLoudness;
+	features = currentFeatures;
+}
+
 std::vector<float> FFTProcessor::getSpectralEnvelope() const {
 	std::lock_guard lock(peaksMutex);
 	return spectralEnvelope;
@@ -113,16 +195,59 @@ std::vector<float> FFTProcessor::getMagnitudesBuffer() const {
 	return magnitudesBuffer;
 }
 
+FFTProcessor::BandGains FFTProcessor::readGains() const {
+	std::lock_guard gainsLock(gainsMutex);
+	return {lowGain, midGain, highGain};
+}
+
+float FFTProcessor::perceptualGain(const float freq, const BandGains& gains) {
+	const float lowResponse = std::clamp(1.0f - std::max(0.0f, (freq - 200.0f) / 50.0f), 0.0f, 1.0f);
+	const float highResponse = std::clamp((freq - 1900.0f) / 100.0f, 0.0f, 1.0f);
+	const float midResponse = std::clamp(1.0f - lowResponse - highResponse, 0.0f, 1.0f);
+
+	const float f2 = freq * freq;
+	const float numerator = 12200.0f * 12200.0f * f2 * f2;
+	const float denominator = (f2 + 20.6f * 20.6f) *
+							  std::sqrt((f2 + 107.7f * 107.7f) * (f2 + 737.9f * 737.9f)) *
+							  (f2 + 12200.0f * 12200.0f);
+
+	const float aWeight = numerator / denominator;
+	const float dbAdjustment = 2.0f * FastMath::log10(std::max(aWeight, 1e-20f)) + 2.0f;
+	const float aWeightGain = FastMath::exp(dbAdjustment * 0.11512925f); // ln(10)/20 ≈ 0.11512925
+
+	const float combinedGain = aWeightGain * (lowResponse * gains.low + midResponse * gains.mid +
+											  highResponse * gains.high);
+	return std::clamp(combinedGain, 0.0f, 4.0f);
+}
+
+void FFTProcessor::updateRateTables(const float sampleRate, const BandGains& gains) {
+	if (sampleRate == tableSampleRate && gains == tableGains) {
+		return;
+	}
+	tableSampleRate = sampleRate;
+	tableGains = gains;
+
+	for (size_t i = 0; i < binGains.size(); ++i) {
+		const float freq = static_cast<float>(i) * sampleRate / FFT_SIZE;
+		binGains[i] = perceptualGain(freq, gains);
+		envelopeWeights[i] = 1.0f + 2.0f * (1.0f - std::min(1.0f, freq / 1000.0f));
+	}
+
+	// Only the bins up to just past the crossover are ever weighted
+	const float lowBandWidth = sampleRate / LowBandAnalyser::FFT_SIZE;
+	const size_t lowBandLimit =
+		std::min(static_cast<size_t>(LowBandAnalyser::CROSSOVER_FREQ / lowBandWidth) + 3,
+				 lowBandGains.size());
+	std::ranges::fill(lowBandGains, 0.0f);
+	for (size_t i = 0; i < lowBandLimit; ++i) {
+		const float freq = static_cast<float>(i) * lowBandWidth;
+		lowBandGains[i] = freq < MIN_FREQ ? 0.0f : perceptualGain(freq, gains);
+	}
+}
+
 void FFTProcessor::processMagnitudes(std::vector<float>& magnitudes, const float sampleRate,
 									 const float maxMagnitude) {
 	const float normalisationFactor = maxMagnitude > 1e-6f ? 1.0f / maxMagnitude : 1.0f;
-	float currentLowGain, currentMidGain, currentHighGain;
-	{
-		std::lock_guard gainsLock(gainsMutex);
-		currentLowGain = lowGain;
-		currentMidGain = midGain;
-		currentHighGain = highGain;
-	}
 
 	std::ranges::fill(spectralEnvelope, 0.0f);
 
@@ -143,10 +268,7 @@ void FFTProcessor::processMagnitudes(std::vector<float>& magnitudes, const float
 	}
 
 	for (size_t i = minBinIndex; i <= maxBinIndex; ++i) {
-		const float freq = static_cast<float>(i) * sampleRate / FFT_SIZE;
-
-		const float melFactor = 1.0f + 2.0f * (1.0f - std::min(1.0f, freq / 1000.0f));
-		spectralEnvelope[i] *= melFactor;
+		spectralEnvelope[i] *= envelopeWeights[i];
 	}
 
 	if (const float maxEnvelope = *std::ranges::max_element(spectralEnvelope);
@@ -157,32 +279,25 @@ void FFTProcessor::processMagnitudes(std::vector<float>& magnitudes, const float
 	}
 
 	for (size_t i = minBinIndex; i <= maxBinIndex; ++i) {
-		const float freq = static_cast<float>(i) * sampleRate / FFT_SIZE;
-
 		const float normalisedMagnitude =
 			std::sqrt(fft_out[i].r * fft_out[i].r + fft_out[i].i * fft_out[i].i) * normalisationFactor;
+		magnitudes[i] = normalisedMagnitude * binGains[i];
+	}
+}
 
-		const float lowResponse =
-			std::clamp(1.0f - std::max(0.0f, (freq - 200.0f) / 50.0f), 0.0f, 1.0f);
-		const float highResponse = std::clamp((freq - 1900.0f) / 100.0f, 0.0f, 1.0f);
-		const float midResponse = std::clamp(1.0f - lowResponse - highResponse, 0.0f, 1.0f);
-
-		const float f2 = freq * freq;
-		const float numerator = 12200.0f * 12200.0f * f2 * f2;
-		const float denominator = (f2 + 20.6f * 20.6f) *
-								  std::sqrt((f2 + 107.7f * 107.7f) * (f2 + 737.9f * 737.9f)) *
-								  (f2 + 12200.0f * 12200.0f);
-
-		const float aWeight = numerator / denominator;
-		const float dbAdjustment = 2.0f * std::log10(aWeight) + 2.0f;
-		const float perceptualGain = std::exp(dbAdjustment * 0.11512925f); // ln(10)/20 ≈ 0.11512925
-
-		float combinedGain =
-			perceptualGain * (lowResponse * currentLowGain + midResponse * currentMidGain +
-							  highResponse * currentHighGain);
+void FFTProcessor::processLowBand(const float sampleRate, const float maxMagnitude) {
+	lowBand.transform();
 
-		combinedGain = std::clamp(combinedGain, 0.0f, 4.0f);
-		magnitudes[i] = normalisedMagnitude * combinedGain;
+	const float normalisationFactor = maxMagnitude > 1e-6f ? 1.0f / maxMagnitude : 1.0f;
+	const float binWidth = sampleRate / LowBandAnalyser::FFT_SIZE;
+	const std::span<const float> raw = lowBand.magnitudes();
+
+	// Two bins past the crossover so a peak just below it can still be compared with both
+	// of its upper neighbours
+	lowBandBins = std::min(
+		static_cast<size_t>(LowBandAnalyser::CROSSOVER_FREQ / binWidth) + 3, raw.size());
+	for (size_t i = 0; i < lowBandBins; ++i) {
+		lowBandMagnitudes[i] = raw[i] * normalisationFactor * lowBandGains[i];
 	}
 }
 
@@ -201,7 +316,6 @@ void FFTProcessor::calculateMagnitudes(std::vector<float>& rawMagnitudes, const
 		for (size_t i = 1; i < fft_out.size() - 1; ++i) {
 			const float freq = static_cast<float>(i) * sampleRate / FFT_SIZE;
 			if (freq < MIN_FREQ || freq > MAX_FREQ) {
-				rawMagnitudes[i] = 0.0f;
 				continue;
 			}
 			
@@ -212,13 +326,14 @@ void FFTProcessor::calculateMagnitudes(std::vector<float>& rawMagnitudes, const
 #endif
 	{
 		for (size_t i = 1; i < fft_out.size() - 1; ++i) {
+			const float magnitudeSquared = fft_out[i].r * fft_out[i].r + fft_out[i].i * fft_out[i].i;
+			const float magnitude = std::sqrt(magnitudeSquared);
+			rawMagnitudes[i] = magnitude;
+
 			if (const float freq = static_cast<float>(i) * sampleRate / FFT_SIZE;
 				freq < MIN_FREQ || freq > MAX_FREQ)
 				continue;
 
-			const float magnitudeSquared = fft_out[i].r * fft_out[i].r + fft_out[i].i * fft_out[i].i;
-			const float magnitude = std::sqrt(magnitudeSquared);
-			rawMagnitudes[i] = magnitude;
 			totalEnergy += magnitudeSquared;
 			maxMagnitude = std::max(maxMagnitude, magnitude);
 		}
@@ -226,79 +341,84 @@ void FFTProcessor::calculateMagnitudes(std::vector<float>& rawMagnitudes, const
 }
 
 void FFTProcessor::findPeaks(const float sampleRate, const float noiseFloor,
+							 const std::span<const float> binThresholds, const float spectralFlatness,
 							 std::vector<FrequencyPeak>& peaks) const {
+	const bool perBin = binThresholds.size() == magnitudesBuffer.size();
+	const PeakInterpolation method = peakInterpolation.load(std::memory_order_relaxed);
 	candidatePeaksBuffer.clear();
+
+	float lowestMainFreq = 0.0f;
+	if (lowBandBins > 0) {
+		lowestMainFreq = LowBandAnalyser::CROSSOVER_FREQ;
+		const float binWidth = sampleRate / LowBandAnalyser::FFT_SIZE;
+		for (size_t i = 2; i + 2 < lowBandBins; ++i) {
+			const float m = lowBandMagnitudes[i];
+			if (m > noiseFloor && m > lowBandMagnitudes[i - 1] && m > lowBandMagnitudes[i - 2] &&
+				m > lowBandMagnitudes[i + 1] && m > lowBandMagnitudes[i + 2]) {
+				if (const float freq = (static_cast<float>(i) + lowBand.refineBin(i)) * binWidth;
+					freq >= MIN_FREQ && freq < LowBandAnalyser::CROSSOVER_FREQ) {
+					candidatePeaksBuffer.push_back({freq, m});
+				}
+			}
+		}
+	}
+
 	for (size_t i = 2; i < magnitudesBuffer.size() - 2; ++i) {
-		if (magnitudesBuffer[i] > noiseFloor && magnitudesBuffer[i] > magnitudesBuffer[i - 1] &&
+		const float threshold = perBin ? std::min(noiseFloor, binThresholds[i]) : noiseFloor;
+		if (magnitudesBuffer[i] > threshold && magnitudesBuffer[i] > magnitudesBuffer[i - 1] &&
 			magnitudesBuffer[i] > magnitudesBuffer[i - 2] &&
 			magnitudesBuffer[i] > magnitudesBuffer[i + 1] &&
 			magnitudesBuffer[i] > magnitudesBuffer[i + 2]) {
-			if (const float freq = interpolateFrequency(static_cast<int>(i), sampleRate);
-				freq >= MIN_FREQ && freq <= MAX_FREQ) {
+			if (const float freq = interpolateFrequency(static_cast<int>(i), sampleRate, method);
+				freq >= std::max(MIN_FREQ, lowestMainFreq) && freq <= MAX_FREQ) {
 				candidatePeaksBuffer.push_back({freq, magnitudesBuffer[i]});
 			}
 		}
 	}
 
-	std::ranges::sort(candidatePeaksBuffer, [](const FrequencyPeak& a, const FrequencyPeak& b) {
+	// Strongest first, but only a window at a time: in dense spectra MAX_PEAKS are usually
+	// accepted long before the weakest candidates would be reached, so those are never sorted
+	const auto stronger = [](const FrequencyPeak& a, const FrequencyPeak& b) {
 		return a.magnitude > b.magnitude;
-	});
-
-	const float spectralFlatness = calculateSpectralFlatness(magnitudesBuffer);
+	};
 	const float harmonic_threshold = spectralFlatness < 0.2f ? 0.15f : 0.5f;
-
-	for (const auto& candidate : candidatePeaksBuffer) {
-		if (peaks.size() >= MAX_PEAKS)
-			break;
-
-		bool isHarmonicFlag = false;
-		for (const auto& existing : peaks) {
-			if (isHarmonic(candidate.frequency, existing.frequency, harmonic_threshold)) {
-				isHarmonicFlag = true;
-				break;
-			}
-		}
-
-		if (!isHarmonicFlag) {
-			peaks.push_back(candidate);
+	harmonicSieve.clear();
+
+	auto windowBegin = candidatePeaksBuffer.begin();
+	const auto candidatesEnd = candidatePeaksBuffer.end();
+	while (windowBegin != candidatesEnd && peaks.size() < MAX_PEAKS) {
+		auto windowEnd = candidatesEnd;
+		if (candidatesEnd - windowBegin > SELECTION_WINDOW) {
+			windowEnd = windowBegin + SELECTION_WINDOW;
+			std::nth_element(windowBegin, windowEnd, candidatesEnd, stronger);
 		}
-	}
-}
+		std::sort(windowBegin, windowEnd, stronger);
 
-float FFTProcessor::calculateSpectralFlatness(const std::vector<float>& magnitudes) {
-	float geometricMean = 0.0f;
-	float arithmeticMean = 0.0f;
-	int count = 0;
-
-	for (const float mag : magnitudes) {
-		if (mag > 1e-6f) {
-			geometricMean += std::log(mag);
-			arithmeticMean += mag;
-			count++;
+		for (; windowBegin != windowEnd && peaks.size() < MAX_PEAKS; ++windowBegin) {
+			if (!harmonicSieve.isForbidden(windowBegin->frequency)) {
+				peaks.push_back(*windowBegin);
+				harmonicSieve.addFundamental(windowBegin->frequency, harmonic_threshold);
+			}
 		}
+		windowBegin = windowEnd;
 	}
-
-	if (count == 0 || arithmeticMean < 1e-6f)
-		return 1.0f;
-
-	geometricMean = std::exp(geometricMean / count);
-	arithmeticMean /= count;
-
-	return geometricMean / arithmeticMean;
 }
 
-void FFTProcessor::findFrequencyPeaks(const float sampleRate) {
+void FFTProcessor::findFrequencyPeaks(const float sampleRate,
+									  const std::chrono::steady_clock::time_point frameTime) {
 	const size_t binCount = fft_out.size();
-	std::vector rawMagnitudes(binCount, 0.0f);
+	std::ranges::fill(rawMagnitudesBuffer, 0.0f);
 	float maxMagnitude = 0.0f;
 	float totalEnergy = 0.0f;
 
-	calculateMagnitudes(rawMagnitudes, sampleRate, maxMagnitude, totalEnergy);
+	calculateMagnitudes(rawMagnitudesBuffer, sampleRate, maxMagnitude, totalEnergy);
 
 	const float rmsValue = std::sqrt(totalEnergy / static_cast<float>(binCount));
-	const float dbFS = 20.0f * std::log10(std::max(rmsValue, 1e-6f));
+	const float dbFS = 20.0f * FastMath::log10(std::max(rmsValue, 1e-6f));
 	const float normalisedLoudness = std::clamp((dbFS + 60.0f) / 60.0f, 0.0f, 1.0f);
 
+	updateRateTables(sampleRate, readGains());
+
 	// Update magnitudes buffer under lock (read by UI thread)
 	{
 		std::lock_guard lock(peaksMutex);
@@ -306,94 +426,93 @@ void FFTProcessor::findFrequencyPeaks(const float sampleRate) {
 		processMagnitudes(magnitudesBuffer, sampleRate, maxMagnitude);
 	}
 
-	const float noiseFloor = calculateNoiseFloor(magnitudesBuffer);
-	std::vector<FrequencyPeak> rawPeaks;
-	findPeaks(sampleRate, noiseFloor, rawPeaks);
+	lowBandBins = 0;
+	if (multiResolution.load(std::memory_order_relaxed)) {
+		processLowBand(sampleRate, maxMagnitude);
+	}
+
+	const SpectralFeatures features =
+		featureExtractor.process(magnitudesBuffer, sampleRate / FFT_SIZE, rmsValue);
+
+	const float noiseFloor = noiseFloorEstimator.estimate(magnitudesBuffer);
+	std::span<const float> binThresholds;
+	if (noiseFloorMode.load(std::memory_order_relaxed) == NoiseFloorMode::PerBin) {
+		noiseFloorEstimator.updateBinFloors(magnitudesBuffer);
+		binThresholds = noiseFloorEstimator.binThresholds();
+	}
+	framePeaks.clear();
+	findPeaks(sampleRate, noiseFloor, binThresholds, features.flatness, framePeaks);
 
 	// Single atomic update of all shared state
 	std::lock_guard lock(peaksMutex);
 	
 	currentLoudness = currentLoudness * 0.7f + normalisedLoudness * 0.3f;
+	currentFeatures = features;
 	
-	const auto now = std::chrono::steady_clock::now();
-	if (!rawPeaks.empty()) {
-		currentPeaks = std::move(rawPeaks);
-		retainedPeaks = currentPeaks;
-		lastValidPeakTime = now;
-	} else if (now - lastValidPeakTime < PEAK_RETENTION_TIME) {
-		currentPeaks = retainedPeaks;
+	if (!framePeaks.empty()) {
+		currentPeaks.swap(framePeaks);
+		retainedPeaks.assign(currentPeaks.begin(), currentPeaks.end());
+		lastValidPeakTime = frameTime;
+	} else if (frameTime - lastValidPeakTime < PEAK_RETENTION_TIME) {
+		currentPeaks.assign(retainedPeaks.begin(), retainedPeaks.end());
 	}
 }
 
-bool FFTProcessor::isHarmonic(const float testFreq, const float baseFreq, const float threshold) {
-	if (baseFreq <= 0.0f || testFreq <= 0.0f)
-		return false;
-
-	const float toleranceHz = std::max(3.0f, baseFreq * threshold);
-
-	for (int h = 2; h <= MAX_HARMONIC; ++h) {
-		if (const float expectedHarmonic = baseFreq * h;
-			std::abs(testFreq - expectedHarmonic) < toleranceHz)
-			return true;
+float FFTProcessor::interpolateFrequency(const int bin, const float sampleRate,
+										 const PeakInterpolation method) const {
+	const float binWidth = sampleRate / FFT_SIZE;
+	if (bin <= 0 || bin >= static_cast<int>(fft_out.size()) - 1) {
+		return static_cast<float>(bin) * binWidth;
 	}
 
-	for (int h = 2; h <= MAX_HARMONIC; ++h) {
-		if (const float expectedHarmonic = testFreq * h;
-			std::abs(baseFreq - expectedHarmonic) < toleranceHz)
-			return true;
+	const auto k = static_cast<size_t>(bin);
+
+	if (method == PeakInterpolation::PhaseVocoder && phaseHop > 0 && phaseHop <= FFT_SIZE) {
+		// Phase advance of this bin since the previous buffer, less what the bin centre
+		// alone would advance, wrapped to (-pi, pi]
+		const FFTComplex& now = fft_out[k];
+		const FFTComplex& before = previousSpectrum[k];
+		const float advance = std::atan2(now.i * before.r - now.r * before.i,
+										 now.r * before.r + now.i * before.i);
+		const auto hop = static_cast<float>(phaseHop);
+		constexpr float TWO_PI = 2.0f * static_cast<float>(M_PI);
+		float deviation = advance - TWO_PI * static_cast<float>(bin) * hop / FFT_SIZE;
+		deviation -= TWO_PI * std::nearbyint(deviation / TWO_PI);
+		return static_cast<float>(bin) * binWidth + deviation * sampleRate / (TWO_PI * hop);
 	}
 
-	return false;
-}
-
-float FFTProcessor::interpolateFrequency(const int bin, const float sampleRate) const {
-	if (bin <= 0 || bin >= static_cast<int>(fft_out.size()) - 1) {
-		return bin * sampleRate / FFT_SIZE;
+	float m0 = rawMagnitudesBuffer[k - 1];
+	float m1 = rawMagnitudesBuffer[k];
+	float m2 = rawMagnitudesBuffer[k + 1];
+	float threshold = 1e-3f;
+
+	if (method != PeakInterpolation::Parabolic) {
+		// Log magnitudes: a Hann main lobe is close to Gaussian, whose log is a parabola
+		m0 = FastMath::log(std::max(m0, 1e-20f));
+		m1 = FastMath::log(std::max(m1, 1e-20f));
+		m2 = FastMath::log(std::max(m2, 1e-20f));
+		threshold = 1e-6f;
 	}
 
-	auto magnitude = [](const kiss_fft_cpx& v) { return std::sqrt(v.r * v.r + v.i * v.i); };
-
-	const float m0 = magnitude(fft_out[static_cast<size_t>(bin - 1)]);
-	const float m1 = magnitude(fft_out[static_cast<size_t>(bin)]);
-	const float m2 = magnitude(fft_out[static_cast<size_t>(bin + 1)]);
-
 	const float denominator = m0 - 2.0f * m1 + m2;
-	if (std::abs(denominator) < 1e-3f)
-		return bin * sampleRate / FFT_SIZE;
+	if (std::abs(denominator) < threshold)
+		return static_cast<float>(bin) * binWidth;
 
 	const float alpha = 0.5f * (m0 - m2) / denominator;
-	return (bin + alpha) * sampleRate / FFT_SIZE;
-}
-
-float FFTProcessor::calculateNoiseFloor(const std::vector<float>& magnitudes) {
-	const size_t estimatedCapacity = magnitudes.size() > 2 ? magnitudes.size() - 2 : 0;
-	std::vector<float> filteredMags;
-	filteredMags.reserve(estimatedCapacity);
-
-	for (size_t i = 1; i < magnitudes.size() - 1; ++i) {
-		if (magnitudes[i] > 1e-6f) {
-			filteredMags.push_back(magnitudes[i]);
-		}
-	}
-
-	if (filteredMags.empty())
-		return 1e-5f;
-	const size_t n = filteredMags.size();
-	const size_t medianIdx = n / 2;
-	std::ranges::nth_element(filteredMags, filteredMags.begin() + static_cast<std::ptrdiff_t>(medianIdx));
-	const float median = filteredMags[medianIdx];
-	const float peak = *std::ranges::max_element(filteredMags);
-	const float adaptiveFactor = 0.1f + 0.05f * std::log2(1.0f + peak / (median + 1e-6f));
-	const float noiseFloor = median * (1.0f + adaptiveFactor);
-
-	return std::max(noiseFloor, 1e-5f);
+	return (static_cast<float>(bin) + alpha) * binWidth;
 }
 
 void FFTProcessor::reset() {
+	std::lock_guard processingLock(processingMutex);
 	std::lock_guard lock(peaksMutex);
 	currentPeaks.clear();
 	retainedPeaks.clear();
 	std::ranges::fill(magnitudesBuffer, 0.0f);
 	std::ranges::fill(spectralEnvelope, 0.0f);
+	featureExtractor.reset();
+	noiseFloorEstimator.reset();
+	lowBand.reset();
+	previousBufferSize = 0;
+	currentFeatures = {};
 	lastValidPeakTime = std::chrono::steady_clock::now();
 }
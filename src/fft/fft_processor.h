@@ -1,11 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <chrono>
+#include <memory>
 #include <mutex>
 #include <span>
 #include <vector>
 
-#include "kiss_fftr.h"
+#include "fft_backend.h"
+#include "harmonic_sieve.h"
+#include "low_band_analyser.h"
+#include "metrics.h"
+#include "noise_floor.h"
+#include "spectral_features.h"
 
 #ifdef USE_NEON_OPTIMISATIONS
 #include "fft_processor_neon.h"
@@ -24,35 +31,98 @@ public:
 		float magnitude;
 	};
 
+	// How a peak's frequency is refined between bin centres
+	enum class PeakInterpolation {
+		Parabolic,	 // parabola through the three bin magnitudes
+		Gaussian,	 // parabola through their logs; much less biased under a Hann window
+		PhaseVocoder // phase advance since the previous buffer; Gaussian when there is none
+	};
+
+	enum class NoiseFloorMode {
+		Global,	 // one level for the whole spectrum
+		PerBin	 // each bin may also clear its own tracked floor, if that is lower
+	};
+
 	FFTProcessor();
-	~FFTProcessor();
 
 	FFTProcessor(const FFTProcessor&) = delete;
 	FFTProcessor& operator=(const FFTProcessor&) = delete;
 	FFTProcessor(FFTProcessor&&) noexcept = delete;
 	FFTProcessor& operator=(FFTProcessor&&) noexcept = delete;
 
-	void processBuffer(std::span<const float> buffer, float sampleRate);
+	// frameTime drives peak retention; offline analysis passes the position in the file so
+	// results do not depend on how fast the file is processed
+	void processBuffer(std::span<const float> buffer, float sampleRate,
+					   std::chrono::steady_clock::time_point frameTime = std::chrono::steady_clock::now());
+	// Analyses a window that overlaps the previous one: only its newest newSamples follow
+	// on from the last call. processBuffer is this with every sample new.
+	void processWindow(std::span<const float> window, size_t newSamples, float sampleRate,
+					   std::chrono::steady_clock::time_point frameTime);
 	std::vector<FrequencyPeak> getDominantFrequencies() const;
 	std::vector<float> getMagnitudesBuffer() const;
 	std::vector<float> getSpectralEnvelope() const;
 	float getCurrentLoudness() const;
+	SpectralFeatures getSpectralFeatures() const;
+	// All of the above in one locked pass, assigned into the caller's vectors so their
+	// capacity is reused from frame to frame
+	void copyResults(std::vector<FrequencyPeak>& peaks, std::vector<float>& magnitudes,
+					 std::vector<float>& envelope, float& loudness,
+					 SpectralFeatures& features) const;
 	void reset();
 	void setEQGains(float low, float mid, float high);
+	void setNoiseFloorMode(NoiseFloorMode mode) { noiseFloorMode.store(mode); }
+	NoiseFloorMode getNoiseFloorMode() const { return noiseFloorMode.load(); }
+	void setPeakInterpolation(PeakInterpolation method) { peakInterpolation.store(method); }
+	PeakInterpolation getPeakInterpolation() const { return peakInterpolation.load(); }
+	// Takes peaks below LowBandAnalyser::CROSSOVER_FREQ from a longer window. Bass pitch
+	// becomes four times finer at the cost of one more transform per buffer and a window
+	// that reaches further back in time.
+	void setMultiResolution(bool enabled) { multiResolution.store(enabled); }
+	bool isMultiResolution() const { return multiResolution.load(); }
+	// Replaces the transform used by both windows. Plans are made before the current
+	// frame is waited for, so a slow planner does not stall analysis; throws if kind is
+	// not built in, leaving the current backend in place.
+	void setFFTBackend(FFTBackend::Kind kind);
+	FFTBackend::Kind getFFTBackend() const;
+	// Takes over every setting above and the EQ gains, but none of other's analysis state
+	void copySettings(const FFTProcessor& other);
 
 private:
-	kiss_fftr_cfg fft_cfg;
+	friend struct FFTProcessorBenchmarkAccess;
+
+	std::unique_ptr<FFTBackend> fftBackend;
 	std::vector<float> fft_in;
-	std::vector<kiss_fft_cpx> fft_out;
+	std::vector<FFTComplex> fft_out;
 
 	std::vector<FrequencyPeak> currentPeaks;
 	mutable std::vector<FrequencyPeak> candidatePeaksBuffer; // Pre-allocated buffer for hot path
+	mutable HarmonicSieve harmonicSieve{MIN_FREQ, MAX_FREQ, MAX_HARMONIC};
+	static constexpr std::ptrdiff_t SELECTION_WINDOW = 2 * MAX_PEAKS;
 	mutable std::mutex peaksMutex;
 
 	std::vector<float> hannWindow;
 	std::vector<float> magnitudesBuffer;
 	std::vector<float> spectralEnvelope;
 
+	// Worker-owned scratch, sized once in the constructor so a frame allocates nothing
+	std::vector<float> rawMagnitudesBuffer;
+	std::vector<FrequencyPeak> framePeaks;	// swapped into currentPeaks on publication
+
+	// Previous buffer's spectrum for PeakInterpolation::PhaseVocoder
+	std::vector<FFTComplex> previousSpectrum;
+	size_t previousBufferSize = 0;
+	float previousSampleRate = 0.0f;
+	size_t phaseHop = 0;	// samples since previousSpectrum, or 0 if it cannot be used
+	std::atomic<PeakInterpolation> peakInterpolation{PeakInterpolation::Parabolic};
+
+	LowBandAnalyser lowBand;
+	std::vector<float> lowBandMagnitudes;	// weighted like magnitudesBuffer
+	size_t lowBandBins = 0;	// bins of lowBandMagnitudes in use; 0 when multi-resolution is off
+	std::atomic<bool> multiResolution{false};
+
+	NoiseFloorEstimator noiseFloorEstimator;
+	std::atomic<NoiseFloorMode> noiseFloorMode{NoiseFloorMode::Global};
+
 	std::chrono::steady_clock::time_point lastValidPeakTime;
 	static constexpr std::chrono::milliseconds PEAK_RETENTION_TIME{100};
 	std::vector<FrequencyPeak> retainedPeaks;
@@ -66,17 +136,45 @@ private:
 	float currentLoudness;
 	static constexpr float LOUDNESS_SMOOTHING = 0.2f;
 
-	void applyWindow(std::span<const float> buffer);
-	void findFrequencyPeaks(float sampleRate);
-	float interpolateFrequency(int bin, float sampleRate) const;
-	static float calculateNoiseFloor(const std::vector<float>& magnitudes);
-	static bool isHarmonic(float testFreq, float baseFreq, float threshold = 0.03f);
+	SpectralFeatureExtractor featureExtractor;
+	SpectralFeatures currentFeatures;
 
-	static float calculateSpectralFlatness(const std::vector<float>& magnitudes);
+	Metrics::Histogram& processDuration;
+
+	void applyWindow(std::span<const float> buffer);
+	void findFrequencyPeaks(float sampleRate, std::chrono::steady_clock::time_point frameTime);
+	// Reads rawMagnitudesBuffer, so only valid after calculateMagnitudes for this frame
+	float interpolateFrequency(int bin, float sampleRate, PeakInterpolation method) const;
 
 	void calculateMagnitudes(std::vector<float>& rawMagnitudes, float sampleRate,
 							 float& maxMagnitude, float& totalEnergy) const;
 
+	struct BandGains {
+		float low;
+		float mid;
+		float high;
+
+		bool operator==(const BandGains&) const = default;
+	};
+	BandGains readGains() const;
+	// A-weighting combined with the EQ band gains
+	static float perceptualGain(float freq, const BandGains& gains);
+
+	// Per-bin weights that depend only on the sample rate and EQ, rebuilt when either
+	// changes rather than evaluated for every bin of every frame
+	std::vector<float> binGains;		  // perceptualGain at each bin's centre
+	std::vector<float> envelopeWeights;	  // emphasis of the bass in the spectral envelope
+	std::vector<float> lowBandGains;	  // perceptualGain for the low band, 0 below MIN_FREQ
+	float tableSampleRate = 0.0f;
+	BandGains tableGains{};
+	void updateRateTables(float sampleRate, const BandGains& gains);
+
 	void processMagnitudes(std::vector<float>& magnitudes, float sampleRate, float maxMagnitude);
-	void findPeaks(float sampleRate, float noiseFloor, std::vector<FrequencyPeak>& peaks) const;
+	// Fills lowBandMagnitudes up to the crossover, normalised against the short window's
+	// maxMagnitude so the two sets of peaks compete on the same scale
+	void processLowBand(float sampleRate, float maxMagnitude);
+	// binThresholds, if not empty, lowers the threshold of any bin whose own floor is
+	// below noiseFloor. With lowBandBins set, peaks below the crossover come from the low band.
+	void findPeaks(float sampleRate, float noiseFloor, std::span<const float> binThresholds,
+				   float spectralFlatness, std::vector<FrequencyPeak>& peaks) const;
 };
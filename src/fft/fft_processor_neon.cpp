@@ -314,7 +314,7 @@ float vectorMax(std::span<const float> data) {
 }
 
 void calculateMagnitudesFromComplex(std::span<float> magnitudes, 
-                                   const kiss_fft_cpx* fft_output, size_t count) {
+                                   const FFTComplex* fft_output, size_t count) {
     const size_t size = std::min(magnitudes.size(), count);
     const size_t vectorSize = size & ~3u;
     size_t i = 0;
@@ -0,0 +1,48 @@
+#include "fftw_backend.h"
+
+#include <algorithm>
+#include <cstring>
+#include <mutex>
+#include <stdexcept>
+
+static_assert(sizeof(FFTComplex) == sizeof(fftwf_complex),
+			  "FFTComplex must match fftwf_complex so output can be copied bin for bin");
+
+namespace {
+
+// Only fftwf_execute is thread-safe; planning and freeing plans are not
+std::mutex& planMutex() {
+	static std::mutex mutex;
+	return mutex;
+}
+
+}
+
+FFTWBackend::FFTWBackend(const int size) : FFTBackend(Kind::FFTW, size) {
+	alignedInput = fftwf_alloc_real(static_cast<size_t>(size));
+	alignedOutput = fftwf_alloc_complex(static_cast<size_t>(size / 2 + 1));
+	if (alignedInput && alignedOutput) {
+		std::lock_guard lock(planMutex());
+		plan = fftwf_plan_dft_r2c_1d(size, alignedInput, alignedOutput, FFTW_MEASURE);
+	}
+	if (!plan) {
+		fftwf_free(alignedInput);
+		fftwf_free(alignedOutput);
+		throw std::runtime_error("Error creating FFTW plan.");
+	}
+}
+
+FFTWBackend::~FFTWBackend() {
+	{
+		std::lock_guard lock(planMutex());
+		fftwf_destroy_plan(plan);
+	}
+	fftwf_free(alignedInput);
+	fftwf_free(alignedOutput);
+}
+
+void FFTWBackend::forward(const std::span<const float> input, const std::span<FFTComplex> output) {
+	std::copy_n(input.data(), size(), alignedInput);
+	fftwf_execute(plan);
+	std::memcpy(output.data(), alignedOutput, static_cast<size_t>(size() / 2 + 1) * sizeof(FFTComplex));
+}
@@ -0,0 +1,51 @@
+#include "harmonic_sieve.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+HarmonicSieve::HarmonicSieve(const float lowestFreq, const float highestFreq, const int harmonics)
+	: minFreq(lowestFreq),
+	  maxFreq(highestFreq),
+	  maxHarmonic(harmonics),
+	  firstKey(keyFor(lowestFreq)) {
+	if (!(lowestFreq > 0.0f) || keyFor(highestFreq) - firstKey >= CELLS) {
+		throw std::invalid_argument("HarmonicSieve range must be positive and span at most 16 octaves");
+	}
+}
+
+void HarmonicSieve::forbid(const float low, const float high) {
+	if (high <= minFreq || low >= maxFreq) {
+		return;
+	}
+
+	const size_t first = cellFor(low);
+	const size_t last = cellFor(high);
+	const size_t firstWord = first / 64;
+	const size_t lastWord = last / 64;
+	const uint64_t firstMask = ~uint64_t{0} << (first % 64);
+	const uint64_t lastMask = ~uint64_t{0} >> (63 - last % 64);
+
+	if (firstWord == lastWord) {
+		cells[firstWord] |= firstMask & lastMask;
+		return;
+	}
+
+	cells[firstWord] |= firstMask;
+	for (size_t word = firstWord + 1; word < lastWord; ++word) {
+		cells[word] = ~uint64_t{0};
+	}
+	cells[lastWord] |= lastMask;
+}
+
+void HarmonicSieve::addFundamental(const float fundamental, const float tolerance) {
+	if (fundamental <= 0.0f) {
+		return;
+	}
+
+	const float toleranceHz = std::max(3.0f, fundamental * tolerance);
+	for (int h = 2; h <= maxHarmonic; ++h) {
+		const auto harmonic = static_cast<float>(h);
+		forbid(fundamental * harmonic - toleranceHz, fundamental * harmonic + toleranceHz);
+		forbid((fundamental - toleranceHz) / harmonic, (fundamental + toleranceHz) / harmonic);
+	}
+}
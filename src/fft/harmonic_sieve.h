@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Log-frequency occupancy bitmap for harmonic suppression. Each accepted fundamental marks
+// the bands around its harmonics and subharmonics as forbidden, so testing a candidate is
+// one bit lookup instead of a loop over every accepted peak.
+//
+// Cells are 1/256 octave, cut straight from the float's exponent and top mantissa bits so
+// no log is taken. Bands are widened to whole cells, so a frequency right at the edge of
+// a tolerance band may be rejected where an exact comparison would have let it through.
+class HarmonicSieve {
+public:
+	static constexpr uint32_t CELLS_PER_OCTAVE_BITS = 8;
+	static constexpr size_t CELLS = 4096;	// 16 octaves
+
+	HarmonicSieve(float lowestFreq, float highestFreq, int harmonics);
+
+	void clear() { cells.fill(0); }
+
+	// Forbids every frequency within max(3 Hz, fundamental * tolerance) of a harmonic
+	// 2..maxHarmonic of fundamental, or whose own harmonic lands that close to it
+	void addFundamental(float fundamental, float tolerance);
+
+	bool isForbidden(const float freq) const {
+		const size_t cell = cellFor(freq);
+		return (cells[cell / 64] >> (cell % 64)) & 1u;
+	}
+
+private:
+	float minFreq;
+	float maxFreq;
+	int maxHarmonic;
+	uint32_t firstKey;
+	std::array<uint64_t, CELLS / 64> cells{};
+
+	static uint32_t keyFor(const float freq) {
+		return std::bit_cast<uint32_t>(freq) >> (23 - CELLS_PER_OCTAVE_BITS);
+	}
+
+	size_t cellFor(const float freq) const {
+		const float clamped = freq < minFreq ? minFreq : (freq > maxFreq ? maxFreq : freq);
+		return keyFor(clamped) - firstKey;
+	}
+
+	void forbid(float low, float high);
+};
@@ -0,0 +1,89 @@
+#include "low_band_analyser.h"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include "fast_math.h"
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+LowBandAnalyser::LowBandAnalyser()
+	: fftBackend(FFTBackend::create(FFTBackend::Kind::KissFFT, FFT_SIZE)),
+	  history(FFT_SIZE, 0.0f),
+	  window(FFT_SIZE),
+	  fftInput(FFT_SIZE),
+	  fftOutput(FFT_SIZE / 2 + 1),
+	  binMagnitudes(FFT_SIZE / 2 + 1, 0.0f) {
+	for (size_t i = 0; i < window.size(); ++i) {
+		window[i] = 0.5f * (1.0f - std::cos(2.0f * static_cast<float>(M_PI) * static_cast<float>(i) /
+											(FFT_SIZE - 1)));
+	}
+}
+
+void LowBandAnalyser::setBackend(std::unique_ptr<FFTBackend> backend) {
+	if (!backend || backend->size() != FFT_SIZE) {
+		throw std::invalid_argument("Low-band FFT backend must be created for LowBandAnalyser::FFT_SIZE");
+	}
+	fftBackend = std::move(backend);
+}
+
+void LowBandAnalyser::push(std::span<const float> samples) {
+	if (samples.size() >= history.size()) {
+		samples = samples.last(history.size());
+		std::ranges::copy(samples, history.begin());
+		writePosition = 0;
+		return;
+	}
+
+	const size_t firstPart = std::min(samples.size(), history.size() - writePosition);
+	std::ranges::copy(samples.first(firstPart), history.begin() + static_cast<std::ptrdiff_t>(writePosition));
+	std::ranges::copy(samples.subspan(firstPart), history.begin());
+	writePosition = (writePosition + samples.size()) % history.size();
+}
+
+void LowBandAnalyser::transform() {
+	// Unroll the ring oldest-first while windowing
+	const size_t tail = history.size() - writePosition;
+	for (size_t i = 0; i < tail; ++i) {
+		fftInput[i] = history[writePosition + i] * window[i];
+	}
+	for (size_t i = tail; i < history.size(); ++i) {
+		fftInput[i] = history[i - tail] * window[i];
+	}
+
+	fftBackend->forward(fftInput, fftOutput);
+
+	constexpr float scaleFactor = 2.0f / FFT_SIZE;
+	for (size_t i = 0; i < fftOutput.size(); ++i) {
+		const float r = fftOutput[i].r;
+		const float im = fftOutput[i].i;
+		binMagnitudes[i] = std::sqrt(r * r + im * im) * scaleFactor;
+	}
+	binMagnitudes.front() *= 0.5f;
+	binMagnitudes.back() *= 0.5f;
+}
+
+float LowBandAnalyser::refineBin(const size_t bin) const {
+	if (bin == 0 || bin + 1 >= binMagnitudes.size()) {
+		return 0.0f;
+	}
+
+	const float m0 = FastMath::log(std::max(binMagnitudes[bin - 1], 1e-20f));
+	const float m1 = FastMath::log(std::max(binMagnitudes[bin], 1e-20f));
+	const float m2 = FastMath::log(std::max(binMagnitudes[bin + 1], 1e-20f));
+
+	const float denominator = m0 - 2.0f * m1 + m2;
+	if (std::abs(denominator) < 1e-6f) {
+		return 0.0f;
+	}
+	return std::clamp(0.5f * (m0 - m2) / denominator, -0.5f, 0.5f);
+}
+
+void LowBandAnalyser::reset() {
+	std::ranges::fill(history, 0.0f);
+	writePosition = 0;
+	std::ranges::fill(binMagnitudes, 0.0f);
+}
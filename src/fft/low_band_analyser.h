@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "fft_backend.h"
+
+// Long-window transform for the bass band. A 2048-point FFT has ~21.5 Hz bins at 44.1 kHz,
+// so everything below ~100 Hz falls into a handful of them. This keeps the most recent
+// FFT_SIZE samples across buffers and transforms them as one window, giving 4x the
+// resolution where it matters; FFTProcessor takes its peaks below CROSSOVER_FREQ from here
+// and everything above from the short window, so only the bass pays the longer latency.
+class LowBandAnalyser {
+public:
+	static constexpr int FFT_SIZE = 8192;
+	static constexpr float CROSSOVER_FREQ = 250.0f;
+
+	LowBandAnalyser();
+
+	LowBandAnalyser(const LowBandAnalyser&) = delete;
+	LowBandAnalyser& operator=(const LowBandAnalyser&) = delete;
+	LowBandAnalyser(LowBandAnalyser&&) noexcept = delete;
+	LowBandAnalyser& operator=(LowBandAnalyser&&) noexcept = delete;
+
+	// Takes over a backend created for FFT_SIZE
+	void setBackend(std::unique_ptr<FFTBackend> backend);
+
+	// Appends to the history; only the newest FFT_SIZE samples are kept
+	void push(std::span<const float> samples);
+
+	// Windows and transforms the history. Magnitudes are scaled like FFTProcessor's raw
+	// magnitudes, so a sinusoid reads the same in both transforms.
+	void transform();
+	std::span<const float> magnitudes() const { return binMagnitudes; }
+
+	// Offset in bins (-0.5 to 0.5) of a local maximum's true centre, from a parabola
+	// through the log magnitudes of it and its neighbours
+	float refineBin(size_t bin) const;
+
+	void reset();
+
+private:
+	std::unique_ptr<FFTBackend> fftBackend;
+	std::vector<float> history;	 // ring buffer, oldest sample at writePosition
+	size_t writePosition = 0;
+	std::vector<float> window;
+	std::vector<float> fftInput;
+	std::vector<FFTComplex> fftOutput;
+	std::vector<float> binMagnitudes;
+};
@@ -0,0 +1,92 @@
+#include "noise_floor.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace {
+
+constexpr uint32_t MANTISSA_SHIFT = 20;	// keeps the exponent and three mantissa bits
+constexpr int32_t FIRST_BUCKET_KEY = (127 + NoiseFloorEstimator::MIN_EXPONENT) << 3;
+
+// Lower edge of a bucket, rebuilt from the same bits the bucket index was cut from
+float bucketEdge(const size_t bucket) {
+	return std::bit_cast<float>(static_cast<uint32_t>(static_cast<int32_t>(bucket) + FIRST_BUCKET_KEY)
+								<< MANTISSA_SHIFT);
+}
+
+}
+
+float NoiseFloorEstimator::estimate(const std::span<const float> magnitudes) {
+	if (magnitudes.size() < 3) {
+		return 1e-5f;
+	}
+
+	histogram.fill(0);
+	uint32_t count = 0;
+	float peak = 0.0f;
+
+	for (size_t i = 1; i < magnitudes.size() - 1; ++i) {
+		const float magnitude = magnitudes[i];
+		if (!(magnitude > MIN_MAGNITUDE)) {
+			continue;
+		}
+
+		const auto key = static_cast<int32_t>(std::bit_cast<uint32_t>(magnitude) >> MANTISSA_SHIFT);
+		const auto bucket =
+			static_cast<size_t>(std::clamp(key - FIRST_BUCKET_KEY, 0, static_cast<int32_t>(BUCKETS) - 1));
+		++histogram[bucket];
+		++count;
+		peak = std::max(peak, magnitude);
+	}
+
+	if (count == 0) {
+		return 1e-5f;
+	}
+
+	// Same rank nth_element would land on; interpolated within its bucket
+	const uint32_t rank = count / 2;
+	uint32_t below = 0;
+	float median = peak;
+	for (size_t bucket = 0; bucket < BUCKETS; ++bucket) {
+		const uint32_t inBucket = histogram[bucket];
+		if (below + inBucket > rank) {
+			const float fraction =
+				(static_cast<float>(rank - below) + 0.5f) / static_cast<float>(inBucket);
+			const float lower = bucketEdge(bucket);
+			const float upper = bucket + 1 < BUCKETS ? bucketEdge(bucket + 1) : peak;
+			median = std::min(lower + fraction * (upper - lower), peak);
+			break;
+		}
+		below += inBucket;
+	}
+
+	const float adaptiveFactor = 0.1f + 0.05f * std::log2(1.0f + peak / (median + 1e-6f));
+	return std::max(median * (1.0f + adaptiveFactor), 1e-5f);
+}
+
+void NoiseFloorEstimator::updateBinFloors(const std::span<const float> magnitudes) {
+	const size_t count = magnitudes.size();
+	if (smoothed.size() != count) {
+		smoothed.assign(magnitudes.begin(), magnitudes.end());
+		floors.assign(magnitudes.begin(), magnitudes.end());
+		thresholds.resize(count);
+	}
+
+	const float* current = magnitudes.data();
+	float* smooth = smoothed.data();
+	float* floor = floors.data();
+	float* threshold = thresholds.data();
+
+	for (size_t i = 0; i < count; ++i) {
+		smooth[i] = BIN_SMOOTHING * smooth[i] + (1.0f - BIN_SMOOTHING) * current[i];
+		floor[i] = std::min(std::max(floor[i], MIN_MAGNITUDE) * BIN_FLOOR_RISE, smooth[i]);
+		threshold[i] = floor[i] * BIN_FLOOR_MARGIN;
+	}
+}
+
+void NoiseFloorEstimator::reset() {
+	smoothed.clear();
+	floors.clear();
+	thresholds.clear();
+}
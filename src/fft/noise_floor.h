@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Noise floor of a magnitude spectrum without copying or partially sorting it. The median
+// comes from a log-spaced histogram filled in one pass over the bins, so the cost is
+// linear in the bin count with a fixed-size walk at the end.
+//
+// Optionally it also tracks a per-bin floor across frames (minimum statistics): each bin
+// follows the minimum of its smoothed magnitude and creeps upwards otherwise. Peaks can
+// then be tested against their own neighbourhood rather than one global level, so
+// broadband noise in one region does not hide tonal peaks in a quieter one.
+class NoiseFloorEstimator {
+public:
+	// Bins at or below this are treated as empty, matching the peak detector
+	static constexpr float MIN_MAGNITUDE = 1e-6f;
+	// Buckets are eighth-octaves read straight from the float's exponent and top three
+	// mantissa bits, covering 2^MIN_EXPONENT up to 2^(MIN_EXPONENT + OCTAVES)
+	static constexpr int MIN_EXPONENT = -20;
+	static constexpr int OCTAVES = 32;
+	static constexpr size_t BUCKETS_PER_OCTAVE = 8;
+	static constexpr size_t BUCKETS = OCTAVES * BUCKETS_PER_OCTAVE;
+
+	// Per-bin tracking, per frame: smoothing of the bin magnitude, how fast the floor may
+	// rise towards it, and how far above its floor a bin must be to count as signal
+	static constexpr float BIN_SMOOTHING = 0.7f;
+	static constexpr float BIN_FLOOR_RISE = 1.01f;
+	static constexpr float BIN_FLOOR_MARGIN = 4.0f;
+
+	// Median of the bins above MIN_MAGNITUDE (ignoring the first and last bin), raised by
+	// a factor that grows with the peak-to-median ratio. Never below 1e-5.
+	float estimate(std::span<const float> magnitudes);
+
+	// Folds this frame into the per-bin floors. Bins are resized, and the history
+	// dropped, when the spectrum size changes.
+	void updateBinFloors(std::span<const float> magnitudes);
+	// Level each bin must exceed to count as signal, or empty before the first update
+	std::span<const float> binThresholds() const { return thresholds; }
+
+	void reset();
+
+private:
+	std::array<uint32_t, BUCKETS> histogram{};
+	std::vector<float> smoothed;
+	std::vector<float> floors;
+	std::vector<float> thresholds;
+};
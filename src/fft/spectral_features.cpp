@@ -0,0 +1,77 @@
+#include "spectral_features.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "fast_math.h"
+
+SpectralFeatures SpectralFeatureExtractor::process(const std::span<const float> magnitudes,
+												   const float binWidth, const float rms) {
+	SpectralFeatures features;
+	features.rms = rms;
+
+	const size_t count = magnitudes.size();
+	if (previousMagnitudes.size() != count) {
+		previousMagnitudes.assign(count, 0.0f);
+	}
+
+	const float* current = magnitudes.data();
+	float* previous = previousMagnitudes.data();
+
+	// Moments are taken in bins rather than Hz to keep the squared terms small enough
+	// for float accumulation; they are scaled by binWidth at the end
+	float sum = 0.0f;
+	float binSum = 0.0f;
+	float binSquaredSum = 0.0f;
+	float energy = 0.0f;
+	float logSum = 0.0f;
+	float present = 0.0f;
+	float rise = 0.0f;
+
+	for (size_t i = 0; i < count; ++i) {
+		const float magnitude = current[i];
+		const float valid = magnitude > MIN_MAGNITUDE ? 1.0f : 0.0f;
+		const float weighted = magnitude * valid;
+		const float bin = static_cast<float>(i);
+
+		sum += weighted;
+		binSum += weighted * bin;
+		binSquaredSum += weighted * bin * bin;
+		energy += weighted * weighted;
+		logSum += valid * FastMath::log(std::max(magnitude, MIN_MAGNITUDE));
+		present += valid;
+		rise += std::max(magnitude - previous[i], 0.0f);
+
+		previous[i] = magnitude;
+	}
+
+	if (present == 0.0f || sum < MIN_MAGNITUDE) {
+		return features;
+	}
+
+	features.flatness = FastMath::exp(logSum / present) / (sum / present);
+
+	const float meanBin = binSum / sum;
+	const float variance = std::max(binSquaredSum / sum - meanBin * meanBin, 0.0f);
+	features.centroid = meanBin * binWidth;
+	features.spread = std::sqrt(variance) * binWidth;
+	features.flux = rise / sum;
+
+	const float rolloffEnergy = energy * ROLLOFF_FRACTION;
+	float cumulative = 0.0f;
+	for (size_t i = 0; i < count; ++i) {
+		if (current[i] > MIN_MAGNITUDE) {
+			cumulative += current[i] * current[i];
+		}
+		if (cumulative >= rolloffEnergy) {
+			features.rolloff = static_cast<float>(i) * binWidth;
+			break;
+		}
+	}
+
+	return features;
+}
+
+void SpectralFeatureExtractor::reset() {
+	std::ranges::fill(previousMagnitudes, 0.0f);
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+// Frame-level descriptors of a magnitude spectrum. Frequencies are in Hz.
+struct SpectralFeatures {
+	float flatness = 1.0f;	// geometric / arithmetic mean: ~0 tonal, 1 noise-like
+	float centroid = 0.0f;	// magnitude-weighted mean frequency
+	float spread = 0.0f;	// magnitude-weighted standard deviation around the centroid
+	float rolloff = 0.0f;	// frequency below which ROLLOFF_FRACTION of the energy lies
+	float flux = 0.0f;		// rectified rise since the previous frame, relative to this frame
+	float rms = 0.0f;		// RMS of the raw (unweighted) spectrum
+};
+
+// Computes every SpectralFeatures field in one branch-free pass over the spectrum, plus
+// a short early-exit scan for the rolloff. Keeps the previous frame for the flux.
+class SpectralFeatureExtractor {
+public:
+	static constexpr float ROLLOFF_FRACTION = 0.85f;
+	// Bins at or below this are treated as empty, matching the peak detector
+	static constexpr float MIN_MAGNITUDE = 1e-6f;
+
+	// Bin i of magnitudes is centred on i * binWidth Hz. rms is passed through since the
+	// caller already has it from the unweighted spectrum.
+	SpectralFeatures process(std::span<const float> magnitudes, float binWidth, float rms);
+
+	// Forgets the previous frame, so the next flux is measured against silence
+	void reset();
+
+private:
+	std::vector<float> previousMagnitudes;
+};
@@ -1,12 +1,44 @@
 #if defined(__APPLE__) || defined(__linux__)
 #include "cli/cli.h"
+#include "cli/daemon.h"
 #include "cli/headless.h"
+#include "metrics/metrics_endpoint.h"
+#include "offline/batch_analyser.h"
+#include "offline/offline_analyser.h"
 #endif
 
 #include <iostream>
+#include <utility>
 
 int app_main(int argc, char** argv);
 
+#if defined(__APPLE__) || defined(__linux__)
+// The GUI builds its own AudioInput from its own settings, so any of these given on the
+// command line would be silently ignored there
+static const char* liveOnlyOption(const CLI::Arguments& args) {
+    const CLI::Arguments defaults;
+    const std::pair<bool, const char*> options[] = {
+        {args.multichannel, "--multichannel"},
+        {args.capture.framesPerBuffer != defaults.capture.framesPerBuffer, "--buffer-size"},
+        {args.capture.suggestedLatency != defaults.capture.suggestedLatency, "--latency"},
+        {args.capture.sampleRate != defaults.capture.sampleRate, "--sample-rate"},
+        {args.capture.decimation != defaults.capture.decimation, "--decimate"},
+        {args.hopSize != defaults.hopSize, "--hop-size"},
+        {args.overflowPolicy != defaults.overflowPolicy, "--overflow-policy"},
+        {args.noiseFloorMode != defaults.noiseFloorMode, "--noise-floor"},
+        {args.peakInterpolation != defaults.peakInterpolation, "--interpolation"},
+        {args.multiResolution != defaults.multiResolution, "--multi-resolution"},
+        {args.fftBackend != defaults.fftBackend, "--fft-backend"},
+    };
+    for (const auto& [set, name] : options) {
+        if (set) {
+            return name;
+        }
+    }
+    return nullptr;
+}
+#endif
+
 int main(int argc, char* argv[]) {
 #if defined(__APPLE__) || defined(__linux__)
     CLI::Arguments args = CLI::Arguments::parseCommandLine(argc, argv);
@@ -21,16 +53,56 @@ int main(int argc, char* argv[]) {
         return 0;
     }
 
-    if (args.headless) {
+    if (args.listDevices) {
+        CLI::Daemon::listDevices();
+        return 0;
+    }
+
+    // --output names the offline results file; anywhere else it would be silently ignored
+    if (!args.outputFile.empty() && args.inputFile.empty()) {
+        std::cerr << "--output <path> needs --input-file; use --output-dir with --batch and "
+                  << "--stream <ndjson|binary> for live output" << std::endl;
+        return 1;
+    }
+
+    if (!args.batchSource.empty()) {
+        return Offline::runBatch(args.batchSource, {args.outputDir, args.outputFormat, args.jobs});
+    }
+
+    if (!args.inputFile.empty()) {
+        return Offline::analyseFile(args.inputFile, args.outputFile, args.outputFormat);
+    }
+
+    Metrics::MetricsEndpoint metricsEndpoint(args.metricsSocket);
+    if (!args.metricsSocket.empty() && !metricsEndpoint.start()) {
+        std::cerr << "Failed to start metrics endpoint on " << args.metricsSocket << ": "
+                  << metricsEndpoint.getError() << std::endl;
+    }
+
+    if (args.headless || args.streamFormat != CLI::StreamFormat::None) {
         try {
             CLI::HeadlessInterface interface;
-            interface.run(args.enableAPI, args.audioDevice);
-            return 0;
+            interface.setOverflowPolicy(args.overflowPolicy);
+            interface.setNoiseFloorMode(args.noiseFloorMode);
+            interface.setPeakInterpolation(args.peakInterpolation);
+            interface.setMultiResolution(args.multiResolution);
+            interface.setFFTBackend(args.fftBackend);
+            interface.setCaptureConfig(args.capture);
+            interface.setHopSize(args.hopSize);
+            interface.setStreamFormat(args.streamFormat);
+            interface.setMultichannel(args.multichannel);
+            return interface.run(args.enableAPI, args.audioDevice);
         } catch (const std::exception& e) {
             std::cerr << "Error in headless mode: " << e.what() << std::endl;
             return 1;
         }
     }
+
+    if (const char* option = liveOnlyOption(args)) {
+        std::cerr << option << " needs --headless or --stream; the GUI uses its own capture "
+                  << "and analysis settings" << std::endl;
+        return 1;
+    }
 #endif
 
     return app_main(argc, argv);
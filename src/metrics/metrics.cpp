@@ -0,0 +1,178 @@
+#include "metrics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace Metrics {
+
+namespace {
+
+std::string formatValue(const double value) {
+	if (std::isinf(value)) {
+		return value > 0.0 ? "+Inf" : "-Inf";
+	}
+	if (std::isnan(value)) {
+		return "NaN";
+	}
+
+	std::ostringstream stream;
+	stream.precision(12);
+	stream << value;
+	return stream.str();
+}
+
+std::string seriesName(const std::string& name, const std::string& labels,
+					   const std::string& extraLabel = "") {
+	if (labels.empty() && extraLabel.empty()) {
+		return name;
+	}
+
+	std::string result = name + "{" + labels;
+	if (!labels.empty() && !extraLabel.empty()) {
+		result += ",";
+	}
+	result += extraLabel + "}";
+	return result;
+}
+
+}
+
+Histogram::Histogram(std::vector<double> upperBounds)
+	: bounds(std::move(upperBounds)),
+	  buckets(std::make_unique<std::atomic<uint64_t>[]>(bounds.size() + 1)) {
+	std::ranges::sort(bounds);
+	for (size_t i = 0; i <= bounds.size(); ++i) {
+		buckets[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void Histogram::observe(const double value) {
+	const auto bucket = static_cast<size_t>(std::ranges::lower_bound(bounds, value) - bounds.begin());
+	buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+	count.fetch_add(1, std::memory_order_relaxed);
+
+	double current = sum.load(std::memory_order_relaxed);
+	while (!sum.compare_exchange_weak(current, current + value, std::memory_order_relaxed)) {
+	}
+}
+
+Registry& Registry::instance() {
+	static Registry registry;
+	return registry;
+}
+
+Registry::Series& Registry::findOrCreate(const std::string& name, const std::string& help,
+										 const Type type, const std::string& labels) {
+	auto family = std::ranges::find_if(families, [&](const Family& f) { return f.name == name; });
+	if (family == families.end()) {
+		families.push_back({name, help, type, {}});
+		family = std::prev(families.end());
+	} else if (family->type != type) {
+		throw std::logic_error("Metric " + name + " registered with conflicting types");
+	}
+
+	auto series = std::ranges::find_if(family->series,
+									   [&](const Series& s) { return s.labels == labels; });
+	if (series != family->series.end()) {
+		return *series;
+	}
+
+	family->series.push_back({labels, nullptr, nullptr, nullptr});
+	return family->series.back();
+}
+
+Counter& Registry::counter(const std::string& name, const std::string& help,
+						   const std::string& labels) {
+	std::lock_guard lock(mutex);
+	Series& series = findOrCreate(name, help, Type::Counter, labels);
+	if (!series.counter) {
+		series.counter = std::make_unique<Counter>();
+	}
+	return *series.counter;
+}
+
+Gauge& Registry::gauge(const std::string& name, const std::string& help,
+					   const std::string& labels) {
+	std::lock_guard lock(mutex);
+	Series& series = findOrCreate(name, help, Type::Gauge, labels);
+	if (!series.gauge) {
+		series.gauge = std::make_unique<Gauge>();
+	}
+	return *series.gauge;
+}
+
+Histogram& Registry::histogram(const std::string& name, const std::string& help,
+							   const std::vector<double>& upperBounds,
+							   const std::string& labels) {
+	std::lock_guard lock(mutex);
+	Series& series = findOrCreate(name, help, Type::Histogram, labels);
+	if (!series.histogram) {
+		series.histogram = std::make_unique<Histogram>(upperBounds);
+	}
+	return *series.histogram;
+}
+
+std::string Registry::renderText() const {
+	std::lock_guard lock(mutex);
+	std::ostringstream out;
+
+	for (const auto& family : families) {
+		out << "# HELP " << family.name << " " << family.help << "\n";
+		switch (family.type) {
+			case Type::Counter: out << "# TYPE " << family.name << " counter\n"; break;
+			case Type::Gauge: out << "# TYPE " << family.name << " gauge\n"; break;
+			case Type::Histogram: out << "# TYPE " << family.name << " histogram\n"; break;
+		}
+
+		for (const auto& series : family.series) {
+			if (series.counter) {
+				out << seriesName(family.name, series.labels) << " " << series.counter->get()
+					<< "\n";
+			} else if (series.gauge) {
+				out << seriesName(family.name, series.labels) << " "
+					<< formatValue(series.gauge->get()) << "\n";
+			} else if (series.histogram) {
+				const Histogram& histogram = *series.histogram;
+				const auto& bounds = histogram.getUpperBounds();
+				uint64_t cumulative = 0;
+				for (size_t i = 0; i <= bounds.size(); ++i) {
+					cumulative += histogram.getBucketCount(i);
+					const double bound =
+						i < bounds.size() ? bounds[i] : std::numeric_limits<double>::infinity();
+					out << seriesName(family.name + "_bucket", series.labels,
+									  label("le", formatValue(bound)))
+						<< " " << cumulative << "\n";
+				}
+				out << seriesName(family.name + "_sum", series.labels) << " "
+					<< formatValue(histogram.getSum()) << "\n";
+				out << seriesName(family.name + "_count", series.labels) << " "
+					<< histogram.getCount() << "\n";
+			}
+		}
+	}
+
+	return out.str();
+}
+
+std::string label(const std::string& name, const std::string& value) {
+	std::string escaped;
+	escaped.reserve(value.size());
+	for (const char c : value) {
+		switch (c) {
+			case '\\': escaped += "\\\\"; break;
+			case '"': escaped += "\\\""; break;
+			case '\n': escaped += "\\n"; break;
+			default: escaped += c; break;
+		}
+	}
+	return name + "=\"" + escaped + "\"";
+}
+
+std::vector<double> latencyBucketsSeconds() {
+	return {0.0001, 0.00025, 0.0005, 0.001, 0.0025, 0.005, 0.01, 0.025, 0.05, 0.1, 0.25};
+}
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace Metrics {
+
+// Monotonic counter. Lock-free and safe to bump from the audio callback.
+class Counter {
+public:
+	void increment(const uint64_t amount = 1) { value.fetch_add(amount, std::memory_order_relaxed); }
+	uint64_t get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<uint64_t> value{0};
+};
+
+class Gauge {
+public:
+	void set(const double newValue) { value.store(newValue, std::memory_order_relaxed); }
+	double get() const { return value.load(std::memory_order_relaxed); }
+
+private:
+	std::atomic<double> value{0.0};
+};
+
+// Fixed-bucket histogram. observe() is lock-free; buckets are cumulative only when rendered.
+class Histogram {
+public:
+	explicit Histogram(std::vector<double> upperBounds);
+
+	void observe(double value);
+
+	const std::vector<double>& getUpperBounds() const { return bounds; }
+	uint64_t getBucketCount(size_t index) const {
+		return buckets[index].load(std::memory_order_relaxed);
+	}
+	uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+	double getSum() const { return sum.load(std::memory_order_relaxed); }
+
+private:
+	std::vector<double> bounds;
+	std::unique_ptr<std::atomic<uint64_t>[]> buckets;  // bounds.size() + 1 (the +Inf bucket)
+	std::atomic<uint64_t> count{0};
+	std::atomic<double> sum{0.0};
+};
+
+// Process-wide metric registry. Registration takes a lock and returns a reference that
+// stays valid for the lifetime of the process, so hot paths look a metric up once and
+// keep the reference.
+class Registry {
+public:
+	static Registry& instance();
+
+	Counter& counter(const std::string& name, const std::string& help,
+					 const std::string& labels = "");
+	Gauge& gauge(const std::string& name, const std::string& help,
+				 const std::string& labels = "");
+	Histogram& histogram(const std::string& name, const std::string& help,
+						 const std::vector<double>& upperBounds, const std::string& labels = "");
+
+	// Prometheus text exposition format (version 0.0.4)
+	std::string renderText() const;
+
+private:
+	enum class Type { Counter, Gauge, Histogram };
+
+	struct Series {
+		std::string labels;
+		std::unique_ptr<Counter> counter;
+		std::unique_ptr<Gauge> gauge;
+		std::unique_ptr<Histogram> histogram;
+	};
+
+	struct Family {
+		std::string name;
+		std::string help;
+		Type type;
+		std::deque<Series> series;
+	};
+
+	Registry() = default;
+
+	Series& findOrCreate(const std::string& name, const std::string& help, Type type,
+						 const std::string& labels);
+
+	mutable std::mutex mutex;
+	std::deque<Family> families;
+};
+
+// Formats a single label pair, escaping the value as the exposition format requires.
+std::string label(const std::string& name, const std::string& value);
+
+// Bucket layouts shared by the pipeline's timing histograms
+std::vector<double> latencyBucketsSeconds();
+
+}
@@ -0,0 +1,122 @@
+#include "metrics_endpoint.h"
+#include "metrics.h"
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+
+namespace Metrics {
+
+MetricsEndpoint::MetricsEndpoint(std::string path) : socketPath(std::move(path)) {}
+
+MetricsEndpoint::~MetricsEndpoint() {
+	stop();
+}
+
+bool MetricsEndpoint::start() {
+	if (running.load()) {
+		return true;
+	}
+
+	sockaddr_un addr{};
+	if (socketPath.size() >= sizeof(addr.sun_path)) {
+		error = "socket path is longer than " + std::to_string(sizeof(addr.sun_path) - 1) +
+				" characters";
+		return false;
+	}
+	addr.sun_family = AF_UNIX;
+	std::memcpy(addr.sun_path, socketPath.c_str(), socketPath.size() + 1);
+
+	// Only a socket left behind by an earlier run may be replaced
+	if (struct stat existing{}; lstat(socketPath.c_str(), &existing) == 0) {
+		if (!S_ISSOCK(existing.st_mode)) {
+			error = "path exists and is not a socket";
+			return false;
+		}
+		unlink(socketPath.c_str());
+	}
+
+	serverFd = socket(AF_UNIX, SOCK_STREAM, 0);
+	if (serverFd == -1) {
+		error = std::strerror(errno);
+		return false;
+	}
+
+	if (bind(serverFd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == -1 ||
+		listen(serverFd, 4) == -1) {
+		error = std::strerror(errno);
+		close(serverFd);
+		serverFd = -1;
+		return false;
+	}
+
+	running.store(true);
+	serverThread = std::thread(&MetricsEndpoint::serveLoop, this);
+	return true;
+}
+
+void MetricsEndpoint::stop() {
+	if (!running.exchange(false)) {
+		return;
+	}
+
+	if (serverThread.joinable()) {
+		serverThread.join();
+	}
+
+	close(serverFd);
+	serverFd = -1;
+	unlink(socketPath.c_str());
+}
+
+void MetricsEndpoint::serveLoop() {
+	while (running.load()) {
+		pollfd pollFd = {serverFd, POLLIN, 0};
+		if (poll(&pollFd, 1, 100) <= 0 || !(pollFd.revents & POLLIN)) {
+			continue;
+		}
+
+		const int clientFd = accept(serverFd, nullptr, nullptr);
+		if (clientFd != -1) {
+			serveClient(clientFd);
+			close(clientFd);
+		}
+	}
+}
+
+void MetricsEndpoint::serveClient(const int clientFd) const {
+	// Scrapers send their request immediately; a plain `nc -U` may send nothing at all
+	char request[512];
+	ssize_t requestBytes = 0;
+	pollfd pollFd = {clientFd, POLLIN, 0};
+	if (poll(&pollFd, 1, 100) > 0 && (pollFd.revents & POLLIN)) {
+		requestBytes = recv(clientFd, request, sizeof(request), 0);
+	}
+
+	const std::string body = Registry::instance().renderText();
+	std::string response;
+	if (requestBytes >= 3 && std::memcmp(request, "GET", 3) == 0) {
+		response = "HTTP/1.0 200 OK\r\n"
+				   "Content-Type: text/plain; version=0.0.4\r\n"
+				   "Content-Length: " +
+				   std::to_string(body.size()) + "\r\n\r\n";
+	}
+	response += body;
+
+	size_t sent = 0;
+	while (sent < response.size()) {
+		const ssize_t bytes =
+			send(clientFd, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+		if (bytes <= 0) {
+			break;
+		}
+		sent += static_cast<size_t>(bytes);
+	}
+}
+
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+namespace Metrics {
+
+// Serves Registry::renderText() on a Unix domain socket. Each connection gets one
+// snapshot and is closed; a request starting with "GET" is answered with an HTTP/1.0
+// response so `curl --unix-socket` works, anything else gets the bare exposition text.
+class MetricsEndpoint {
+public:
+	explicit MetricsEndpoint(std::string path);
+	~MetricsEndpoint();
+
+	MetricsEndpoint(const MetricsEndpoint&) = delete;
+	MetricsEndpoint& operator=(const MetricsEndpoint&) = delete;
+
+	// Fails rather than replace anything at the path but a stale socket, or bind a
+	// truncated path; getError() then says why
+	bool start();
+	void stop();
+	bool isRunning() const { return running.load(); }
+	const std::string& getSocketPath() const { return socketPath; }
+	const std::string& getError() const { return error; }
+
+private:
+	void serveLoop();
+	void serveClient(int clientFd) const;
+
+	std::string socketPath;
+	std::string error;
+	int serverFd = -1;
+	std::atomic<bool> running{false};
+	std::thread serverThread;
+};
+
+}
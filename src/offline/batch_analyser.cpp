@@ -0,0 +1,306 @@
+#include "batch_analyser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "mapped_file.h"
+#include "offline_analyser.h"
+#include "wav_reader.h"
+
+namespace Offline {
+
+namespace {
+
+constexpr size_t OUTPUT_BUFFER_SIZE = 1 << 16;
+
+bool isWavFile(const std::filesystem::path& path) {
+	std::string extension = path.extension().string();
+	std::ranges::transform(extension, extension.begin(),
+						   [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return extension == ".wav" || extension == ".wave";
+}
+
+std::filesystem::path absoluteNormal(const std::filesystem::path& path) {
+	return std::filesystem::absolute(path).lexically_normal();
+}
+
+// Deepest directory containing every input, for list files that name no root of their own
+std::filesystem::path commonDirectory(const std::vector<std::string>& paths) {
+	std::filesystem::path common;
+	for (size_t i = 0; i < paths.size(); ++i) {
+		const std::filesystem::path parent = absoluteNormal(paths[i]).parent_path();
+		if (i == 0) {
+			common = parent;
+			continue;
+		}
+		std::filesystem::path shared;
+		for (auto a = common.begin(), b = parent.begin();
+			 a != common.end() && b != parent.end() && *a == *b; ++a, ++b) {
+			shared /= *a;
+		}
+		common = shared;
+	}
+	return common;
+}
+
+}
+
+std::vector<std::string> collectBatchInputs(const std::string& source) {
+	namespace fs = std::filesystem;
+	std::vector<std::pair<uintmax_t, std::string>> found;
+
+	auto add = [&found](const fs::path& path) {
+		std::error_code error;
+		const uintmax_t size = fs::file_size(path, error);
+		found.emplace_back(error ? 0 : size, path.string());
+	};
+
+	if (fs::is_directory(source)) {
+		for (const auto& entry :
+			 fs::recursive_directory_iterator(source, fs::directory_options::skip_permission_denied)) {
+			if (entry.is_regular_file() && isWavFile(entry.path())) {
+				add(entry.path());
+			}
+		}
+	} else {
+		std::ifstream list(source);
+		if (!list) {
+			throw std::runtime_error("Cannot open batch list " + source);
+		}
+		std::string line;
+		while (std::getline(list, line)) {
+			if (!line.empty() && line.back() == '\r') {
+				line.pop_back();
+			}
+			if (!line.empty() && line.front() != '#') {
+				add(line);
+			}
+		}
+	}
+
+	std::ranges::sort(found, [](const auto& a, const auto& b) { return a.first > b.first; });
+
+	std::vector<std::string> inputs;
+	inputs.reserve(found.size());
+	for (auto& [size, path] : found) {
+		inputs.push_back(std::move(path));
+	}
+	return inputs;
+}
+
+BatchAnalyser::BatchAnalyser(BatchOptions batchOptions) : options(std::move(batchOptions)) {
+	if (options.jobs == 0) {
+		options.jobs = std::max(1u, std::thread::hardware_concurrency());
+	}
+}
+
+BatchAnalyser::~BatchAnalyser() = default;
+
+BatchSummary BatchAnalyser::run(const std::vector<std::string>& inputs,
+								 const std::string& sourceRoot) {
+	files = inputs;
+	filesAnalysed = 0;
+	filesFailed = 0;
+	audioMicroseconds = 0;
+
+	const std::vector<size_t> runnable =
+		planOutputs(sourceRoot.empty() ? commonDirectory(files) : absoluteNormal(sourceRoot));
+
+	const size_t workerCount = std::max<size_t>(1, std::min<size_t>(options.jobs, runnable.size()));
+	queues.clear();
+	for (size_t i = 0; i < workerCount; ++i) {
+		queues.push_back(std::make_unique<WorkQueue>());
+	}
+	// Inputs arrive largest first; dealing them round-robin gives every worker a similar mix
+	for (size_t i = 0; i < runnable.size(); ++i) {
+		queues[i % workerCount]->items.push_back(runnable[i]);
+	}
+
+	const auto wallStart = std::chrono::steady_clock::now();
+
+	std::vector<std::thread> workers;
+	workers.reserve(workerCount);
+	for (size_t i = 0; i < workerCount; ++i) {
+		workers.emplace_back(&BatchAnalyser::workerLoop, this, i);
+	}
+	for (auto& worker : workers) {
+		worker.join();
+	}
+
+	BatchSummary summary;
+	summary.filesAnalysed = filesAnalysed.load();
+	summary.filesFailed = filesFailed.load();
+	summary.audioSeconds = static_cast<double>(audioMicroseconds.load()) / 1e6;
+	summary.wallSeconds =
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	return summary;
+}
+
+bool BatchAnalyser::takeWork(const size_t worker, size_t& item) {
+	{
+		WorkQueue& own = *queues[worker];
+		std::lock_guard lock(own.mutex);
+		if (!own.items.empty()) {
+			item = own.items.front();
+			own.items.pop_front();
+			return true;
+		}
+	}
+
+	for (size_t offset = 1; offset < queues.size(); ++offset) {
+		WorkQueue& victim = *queues[(worker + offset) % queues.size()];
+		std::lock_guard lock(victim.mutex);
+		if (!victim.items.empty()) {
+			item = victim.items.back();
+			victim.items.pop_back();
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void BatchAnalyser::workerLoop(const size_t worker) {
+	OfflineAnalyser analyser;
+
+	size_t item = 0;
+	while (takeWork(worker, item)) {
+		try {
+			analyseFile(analyser, item);
+			filesAnalysed.fetch_add(1);
+		} catch (const std::exception& e) {
+			filesFailed.fetch_add(1);
+			std::lock_guard lock(logMutex);
+			std::cerr << "Skipping " << files[item] << ": " << e.what() << std::endl;
+		}
+	}
+}
+
+void BatchAnalyser::analyseFile(OfflineAnalyser& analyser, const size_t item) {
+	const std::string& path = files[item];
+	MappedFile input(path);
+	WavReader reader(input.bytes(), path);
+
+	// Results go to a partial file that is renamed once complete, so a file that fails
+	// part way leaves nothing beside the good results
+	const std::string& outputPath = outputPaths[item];
+	const std::string partialPath = outputPath + ".partial";
+	std::vector<char> outputBuffer(OUTPUT_BUFFER_SIZE);
+	std::ofstream output;
+	output.rdbuf()->pubsetbuf(outputBuffer.data(), static_cast<std::streamsize>(outputBuffer.size()));
+	output.open(partialPath, std::ios::binary);
+	if (!output) {
+		throw std::runtime_error("cannot write " + partialPath);
+	}
+
+	analyser.setBlockCallback([&input](const size_t position) { input.release(position); });
+	try {
+		std::unique_ptr<FrameWriter> writer;
+		if (options.format == OutputFormat::Binary) {
+			writer = std::make_unique<BinaryFrameWriter>(output);
+		} else {
+			writer = std::make_unique<CsvFrameWriter>(output);
+		}
+
+		const AnalysisSummary summary = analyser.analyse(reader, *writer);
+		analyser.setBlockCallback(nullptr);
+		output.close();
+		if (output.fail()) {
+			throw std::runtime_error("cannot finish writing " + partialPath);
+		}
+		std::filesystem::rename(partialPath, outputPath);
+		audioMicroseconds.fetch_add(static_cast<uint64_t>(summary.audioSeconds * 1e6));
+	} catch (...) {
+		analyser.setBlockCallback(nullptr);
+		output.close();
+		std::error_code error;
+		std::filesystem::remove(partialPath, error);
+		throw;
+	}
+}
+
+std::vector<size_t> BatchAnalyser::planOutputs(const std::filesystem::path& root) {
+	namespace fs = std::filesystem;
+	outputPaths.assign(files.size(), {});
+
+	// Two inputs must never share an output: their workers would truncate and write the
+	// same file at once. The first keeps it and the later ones are reported as failed.
+	std::unordered_map<std::string, size_t> owners;
+	std::vector<size_t> runnable;
+	runnable.reserve(files.size());
+	for (size_t i = 0; i < files.size(); ++i) {
+		const fs::path output = outputPathFor(files[i], root);
+		outputPaths[i] = output.string();
+		const auto [owner, claimed] = owners.emplace(absoluteNormal(output).string(), i);
+		if (!claimed) {
+			filesFailed.fetch_add(1);
+			std::cerr << "Skipping " << files[i] << ": its output " << outputPaths[i]
+					  << " would overwrite that of " << files[owner->second] << std::endl;
+			continue;
+		}
+
+		std::error_code error;
+		fs::create_directories(output.parent_path(), error);
+		runnable.push_back(i);
+	}
+	return runnable;
+}
+
+std::filesystem::path BatchAnalyser::outputPathFor(const std::string& path,
+												   const std::filesystem::path& root) const {
+	namespace fs = std::filesystem;
+	fs::path output;
+	if (options.outputDir.empty()) {
+		output = fs::path(path).parent_path();
+	} else {
+		// Mirror the input's place under the root so equal names in different folders stay
+		// apart; anything outside the root lands at the top of the output directory
+		fs::path relative = absoluteNormal(path).parent_path().lexically_relative(root);
+		if (relative.empty() || *relative.begin() == "..") {
+			relative.clear();
+		}
+		output = fs::path(options.outputDir) / relative;
+	}
+	output /= fs::path(path).stem();
+	output += options.format == OutputFormat::Binary ? ".synf" : ".csv";
+	return output;
+}
+
+int runBatch(const std::string& source, const BatchOptions& options) {
+	try {
+		const auto inputs = collectBatchInputs(source);
+		if (inputs.empty()) {
+			std::cerr << "No WAV files found in " << source << std::endl;
+			return 1;
+		}
+
+		BatchAnalyser batch(options);
+		const BatchSummary summary =
+			batch.run(inputs, std::filesystem::is_directory(source) ? source : std::string());
+
+		std::cerr << "Analysed " << summary.filesAnalysed << " files";
+		if (summary.filesFailed > 0) {
+			std::cerr << " (" << summary.filesFailed << " failed)";
+		}
+		std::cerr << ": " << summary.audioSeconds << " s of audio in " << summary.wallSeconds
+				  << " s";
+		if (summary.wallSeconds > 0.0) {
+			std::cerr << ", " << summary.audioSeconds / summary.wallSeconds
+					  << " audio-seconds per wall-second";
+		}
+		std::cerr << std::endl;
+		return summary.filesFailed > 0 ? 2 : 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Batch analysis failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
+
+}
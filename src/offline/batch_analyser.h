@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "frame_writer.h"
+
+namespace Offline {
+
+class OfflineAnalyser;
+
+struct BatchOptions {
+	std::string outputDir;	// mirrors the input folders; empty = beside each input
+	OutputFormat format = OutputFormat::Csv;
+	unsigned jobs = 0;	// 0 = one worker per hardware thread
+};
+
+struct BatchSummary {
+	size_t filesAnalysed = 0;
+	size_t filesFailed = 0;
+	double audioSeconds = 0.0;
+	double wallSeconds = 0.0;
+};
+
+// A directory is searched recursively for .wav files; anything else is read as a list of
+// paths, one per line. Results are sorted largest file first to even out the tail.
+std::vector<std::string> collectBatchInputs(const std::string& source);
+
+// Analyses many files in parallel. Each worker owns an OfflineAnalyser (and with it an
+// FFTProcessor) and a deque of files; idle workers steal from the back of the others'
+// deques. Inputs are memory-mapped and pages are released as they are consumed, and each
+// result streams straight to its own output file, so memory stays bounded regardless of
+// how large or how many the inputs are.
+class BatchAnalyser {
+public:
+	explicit BatchAnalyser(BatchOptions options);
+	~BatchAnalyser();
+
+	// sourceRoot is the searched directory, or empty to use the inputs' common directory.
+	// Inputs whose output would collide with an earlier one are skipped and count as failed.
+	BatchSummary run(const std::vector<std::string>& inputs, const std::string& sourceRoot = {});
+
+private:
+	struct WorkQueue {
+		std::mutex mutex;
+		std::deque<size_t> items;
+	};
+
+	BatchOptions options;
+	std::vector<std::string> files;
+	std::vector<std::string> outputPaths;	// parallel to files
+	std::vector<std::unique_ptr<WorkQueue>> queues;
+
+	std::atomic<size_t> filesAnalysed{0};
+	std::atomic<size_t> filesFailed{0};
+	std::atomic<uint64_t> audioMicroseconds{0};
+	std::mutex logMutex;
+
+	bool takeWork(size_t worker, size_t& item);
+	void workerLoop(size_t worker);
+	// Assigns every file its output and creates the directories; returns the ones to analyse
+	std::vector<size_t> planOutputs(const std::filesystem::path& root);
+	void analyseFile(OfflineAnalyser& analyser, size_t item);
+	std::filesystem::path outputPathFor(const std::string& path,
+										const std::filesystem::path& root) const;
+};
+
+// Entry point for --batch
+int runBatch(const std::string& source, const BatchOptions& options);
+
+}
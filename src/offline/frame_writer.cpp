@@ -0,0 +1,67 @@
+#include "frame_writer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+namespace Offline {
+
+namespace {
+
+template <typename T> void append(std::vector<char>& buffer, const T value) {
+	const size_t offset = buffer.size();
+	buffer.resize(offset + sizeof(T));
+	std::memcpy(buffer.data() + offset, &value, sizeof(T));
+}
+
+}
+
+void FrameWriter::flushOrThrow(std::ostream& out) {
+	out.flush();
+	if (out.fail()) {
+		throw std::runtime_error("writing the results failed");
+	}
+}
+
+void CsvFrameWriter::begin(float /* sampleRate */, int /* fftSize */) {
+	out << "time,r,g,b,dominant_frequency,wavelength,peak_count,peaks\n";
+}
+
+void CsvFrameWriter::writeFrame(const FrameResult& frame) {
+	out << frame.time << ',' << frame.r << ',' << frame.g << ',' << frame.b << ','
+		<< frame.dominantFrequency << ',' << frame.wavelength << ',' << frame.peaks.size() << ',';
+	for (size_t i = 0; i < frame.peaks.size(); ++i) {
+		if (i > 0) {
+			out << ';';
+		}
+		out << frame.peaks[i].frequency << ':' << frame.peaks[i].magnitude;
+	}
+	out << '\n';
+}
+
+void BinaryFrameWriter::begin(const float sampleRate, const int fftSize) {
+	constexpr char magic[4] = {'S', 'Y', 'N', 'F'};
+	scratch.assign(magic, magic + sizeof(magic));
+	append<uint32_t>(scratch, 1);
+	append<uint32_t>(scratch, static_cast<uint32_t>(sampleRate));
+	append<uint32_t>(scratch, static_cast<uint32_t>(fftSize));
+	out.write(scratch.data(), static_cast<std::streamsize>(scratch.size()));
+}
+
+void BinaryFrameWriter::writeFrame(const FrameResult& frame) {
+	scratch.clear();
+	append(scratch, frame.time);
+	append(scratch, frame.r);
+	append(scratch, frame.g);
+	append(scratch, frame.b);
+	append(scratch, frame.dominantFrequency);
+	append(scratch, frame.wavelength);
+	append(scratch, static_cast<uint32_t>(frame.peaks.size()));
+	for (const auto& peak : frame.peaks) {
+		append(scratch, peak.frequency);
+		append(scratch, peak.magnitude);
+	}
+	out.write(scratch.data(), static_cast<std::streamsize>(scratch.size()));
+}
+
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <ostream>
+#include <vector>
+
+#include "fft_processor.h"
+
+namespace Offline {
+
+enum class OutputFormat { Csv, Binary };
+
+// One analysed frame, timed from the start of the input file
+struct FrameResult {
+	double time;
+	float r, g, b;
+	float dominantFrequency;
+	float wavelength;
+	std::vector<FFTProcessor::FrequencyPeak> peaks;
+};
+
+class FrameWriter {
+public:
+	virtual ~FrameWriter() = default;
+
+	virtual void begin(float /* sampleRate */, int /* fftSize */) {}
+	virtual void writeFrame(const FrameResult& frame) = 0;
+	// Throws std::runtime_error if anything written was lost (full disk, closed pipe)
+	virtual void finish() {}
+
+protected:
+	static void flushOrThrow(std::ostream& out);
+};
+
+// time,r,g,b,dominant_frequency,wavelength,peak_count,peaks
+// where peaks is "frequency:magnitude" pairs separated by ';'
+class CsvFrameWriter final : public FrameWriter {
+public:
+	explicit CsvFrameWriter(std::ostream& stream) : out(stream) {}
+
+	void begin(float sampleRate, int fftSize) override;
+	void writeFrame(const FrameResult& frame) override;
+	void finish() override { flushOrThrow(out); }
+
+private:
+	std::ostream& out;
+};
+
+// Little-endian binary track:
+//   header  "SYNF", u32 version (1), u32 sample rate, u32 FFT size
+//   frame   f64 time, f32 r, g, b, dominant frequency, wavelength,
+//           u32 peak count, then peak count x (f32 frequency, f32 magnitude)
+class BinaryFrameWriter final : public FrameWriter {
+public:
+	explicit BinaryFrameWriter(std::ostream& stream) : out(stream) {}
+
+	void begin(float sampleRate, int fftSize) override;
+	void writeFrame(const FrameResult& frame) override;
+	void finish() override { flushOrThrow(out); }
+
+private:
+	std::ostream& out;
+	std::vector<char> scratch;
+};
+
+}
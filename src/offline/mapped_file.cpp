@@ -0,0 +1,51 @@
+#include "mapped_file.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace Offline {
+
+MappedFile::MappedFile(const std::string& path) {
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd == -1) {
+		throw std::runtime_error("Cannot open " + path);
+	}
+
+	struct stat info {};
+	if (fstat(fd, &info) == -1 || info.st_size <= 0) {
+		close(fd);
+		throw std::runtime_error(path + ": empty or unreadable file");
+	}
+	size = static_cast<size_t>(info.st_size);
+
+	void* mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (mapping == MAP_FAILED) {
+		throw std::runtime_error("Cannot map " + path);
+	}
+
+	madvise(mapping, size, MADV_SEQUENTIAL);
+	data = static_cast<const uint8_t*>(mapping);
+}
+
+MappedFile::~MappedFile() {
+	if (data) {
+		munmap(const_cast<uint8_t*>(data), size);
+	}
+}
+
+void MappedFile::release(const size_t offset) {
+	const auto pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	const size_t end = std::min(offset, size) / pageSize * pageSize;
+	if (end > released) {
+		madvise(const_cast<uint8_t*>(data) + released, end - released, MADV_DONTNEED);
+		released = end;
+	}
+}
+
+}
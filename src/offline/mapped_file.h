@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+namespace Offline {
+
+// Read-only memory mapping of a whole file (POSIX). Pages are faulted in on demand, so
+// mapping a large file costs address space rather than memory; release() lets a
+// sequential reader hand back pages it has finished with.
+class MappedFile {
+public:
+	explicit MappedFile(const std::string& path);
+	~MappedFile();
+
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+
+	std::span<const uint8_t> bytes() const { return {data, size}; }
+
+	// Drops resident pages below offset. They are re-read from disk if touched again.
+	void release(size_t offset);
+
+private:
+	const uint8_t* data = nullptr;
+	size_t size = 0;
+	size_t released = 0;
+};
+
+}
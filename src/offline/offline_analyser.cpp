@@ -0,0 +1,110 @@
+#include "offline_analyser.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+namespace Offline {
+
+AnalysisSummary OfflineAnalyser::analyse(WavReader& reader, FrameWriter& writer) {
+	constexpr auto blockFrames = static_cast<size_t>(FFTProcessor::FFT_SIZE);
+	const int channelCount = reader.getChannelCount();
+	const float sampleRate = reader.getSampleRate();
+	const int activeChannel = channel < channelCount ? channel : 0;
+
+	processor.reset();
+	conditioner.setChannelCount(channelCount);
+	conditioner.reset();
+	interleaved.resize(blockFrames * static_cast<size_t>(channelCount));
+	mono.resize(blockFrames);
+
+	AnalysisSummary summary;
+	const auto wallStart = std::chrono::steady_clock::now();
+	const AudioProcessor::Clock::time_point timelineStart{};
+	uint64_t framePosition = 0;
+
+	writer.begin(sampleRate, FFTProcessor::FFT_SIZE);
+
+	while (const size_t framesRead = reader.read(interleaved.data(), blockFrames)) {
+		conditioner.process(interleaved.data(), framesRead, channelCount, activeChannel, mono.data());
+
+		const double time = static_cast<double>(framePosition) / static_cast<double>(sampleRate);
+		processor.analyse(mono.data(), framesRead, sampleRate,
+						  timelineStart + std::chrono::duration_cast<AudioProcessor::Clock::duration>(
+											  std::chrono::duration<double>(time)));
+
+		{
+			const auto analysed = processor.getLatestFrame();
+			frame.time = time;
+			frame.r = analysed->colour.r;
+			frame.g = analysed->colour.g;
+			frame.b = analysed->colour.b;
+			frame.dominantFrequency = analysed->dominantFrequency;
+			frame.wavelength = analysed->colour.dominantWavelength;
+			frame.peaks.assign(analysed->peaks.begin(), analysed->peaks.end());
+		}
+		writer.writeFrame(frame);
+
+		framePosition += framesRead;
+		++summary.frames;
+
+		if (blockCallback) {
+			blockCallback(reader.getPosition());
+		}
+	}
+
+	writer.finish();
+
+	summary.audioSeconds = static_cast<double>(framePosition) / static_cast<double>(sampleRate);
+	summary.wallSeconds =
+		std::chrono::duration<double>(std::chrono::steady_clock::now() - wallStart).count();
+	return summary;
+}
+
+int analyseFile(const std::string& inputPath, const std::string& outputPath,
+				const OutputFormat format) {
+	try {
+		WavReader reader(inputPath);
+
+		std::ofstream file;
+		if (!outputPath.empty()) {
+			file.open(outputPath, std::ios::binary);
+			if (!file) {
+				std::cerr << "Cannot open output file " << outputPath << std::endl;
+				return 1;
+			}
+		}
+		std::ostream& out = outputPath.empty() ? std::cout : file;
+
+		std::unique_ptr<FrameWriter> writer;
+		if (format == OutputFormat::Binary) {
+			writer = std::make_unique<BinaryFrameWriter>(out);
+		} else {
+			writer = std::make_unique<CsvFrameWriter>(out);
+		}
+
+		OfflineAnalyser analyser;
+		const AnalysisSummary summary = analyser.analyse(reader, *writer);
+		if (file.is_open()) {
+			file.close();
+			if (file.fail()) {
+				std::cerr << "Cannot finish writing " << outputPath << std::endl;
+				return 1;
+			}
+		}
+
+		std::cerr << "Analysed " << summary.frames << " frames (" << summary.audioSeconds
+				  << " s of audio) in " << summary.wallSeconds << " s";
+		if (summary.wallSeconds > 0.0) {
+			std::cerr << ", " << summary.audioSeconds / summary.wallSeconds << "x real time";
+		}
+		std::cerr << std::endl;
+		return 0;
+	} catch (const std::exception& e) {
+		std::cerr << "Offline analysis failed: " << e.what() << std::endl;
+		return 1;
+	}
+}
+
+}
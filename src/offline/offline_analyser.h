@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "audio_processor.h"
+#include "frame_writer.h"
+#include "signal_conditioner.h"
+#include "wav_reader.h"
+
+namespace Offline {
+
+struct AnalysisSummary {
+	uint64_t frames = 0;
+	double audioSeconds = 0.0;
+	double wallSeconds = 0.0;
+};
+
+// Runs a decoded file through the same conditioner -> FFT -> colour pipeline as live
+// capture, synchronously and as fast as the CPU allows. Frames are FFT_SIZE samples with
+// no overlap, matching the live callback size, and are timed from the start of the file
+// so results are identical from run to run.
+class OfflineAnalyser {
+public:
+	OfflineAnalyser() = default;
+
+	OfflineAnalyser(const OfflineAnalyser&) = delete;
+	OfflineAnalyser& operator=(const OfflineAnalyser&) = delete;
+
+	void setChannel(const int newChannel) { channel = newChannel; }
+	// Called after each block with the reader's byte position, e.g. to release consumed input
+	void setBlockCallback(std::function<void(size_t)> callback) { blockCallback = std::move(callback); }
+	SignalConditioner& getConditioner() { return conditioner; }
+	AudioProcessor& getProcessor() { return processor; }
+
+	AnalysisSummary analyse(WavReader& reader, FrameWriter& writer);
+
+private:
+	AudioProcessor processor;
+	SignalConditioner conditioner;
+	int channel = 0;
+	std::function<void(size_t)> blockCallback;
+
+	std::vector<float> interleaved;
+	std::vector<float> mono;
+	FrameResult frame{};
+};
+
+// Entry point for --input-file. An empty outputPath writes to stdout.
+int analyseFile(const std::string& inputPath, const std::string& outputPath, OutputFormat format);
+
+}
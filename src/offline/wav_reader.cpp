@@ -0,0 +1,189 @@
+#include "wav_reader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace Offline {
+
+namespace {
+
+constexpr uint16_t WAVE_FORMAT_PCM = 0x0001;
+constexpr uint16_t WAVE_FORMAT_IEEE_FLOAT = 0x0003;
+constexpr uint16_t WAVE_FORMAT_EXTENSIBLE = 0xFFFE;
+
+uint16_t readU16(const uint8_t* bytes) {
+	return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* bytes) {
+	return static_cast<uint32_t>(bytes[0]) | (static_cast<uint32_t>(bytes[1]) << 8) |
+		   (static_cast<uint32_t>(bytes[2]) << 16) | (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+float decodeSample(const uint8_t* bytes, const uint32_t bytesPerSample, const bool isFloat) {
+	if (isFloat) {
+		if (bytesPerSample == 4) {
+			float value;
+			std::memcpy(&value, bytes, sizeof(value));
+			return value;
+		}
+		double value;
+		std::memcpy(&value, bytes, sizeof(value));
+		return static_cast<float>(value);
+	}
+
+	switch (bytesPerSample) {
+		case 1: return (static_cast<float>(bytes[0]) - 128.0f) / 128.0f;
+		case 2: return static_cast<float>(static_cast<int16_t>(readU16(bytes))) / 32768.0f;
+		case 3: {
+			const auto value = static_cast<int32_t>(static_cast<uint32_t>(bytes[0]) << 8 |
+													static_cast<uint32_t>(bytes[1]) << 16 |
+													static_cast<uint32_t>(bytes[2]) << 24) >> 8;
+			return static_cast<float>(value) / 8388608.0f;
+		}
+		default: return static_cast<float>(static_cast<int32_t>(readU32(bytes))) / 2147483648.0f;
+	}
+}
+
+}
+
+WavReader::WavReader(const std::string& path) : file(path, std::ios::binary) {
+	if (!file) {
+		throw std::runtime_error("Cannot open " + path);
+	}
+	parseHeader(path);
+}
+
+WavReader::WavReader(const std::span<const uint8_t> bytes, const std::string& name)
+	: memory(bytes) {
+	parseHeader(name);
+}
+
+const uint8_t* WavReader::fetch(const size_t bytes, size_t& available) {
+	if (!file.is_open()) {
+		available = std::min(bytes, memory.size() - position);
+		const uint8_t* data = memory.data() + position;
+		position += available;
+		return data;
+	}
+
+	rawBuffer.resize(bytes);
+	file.read(reinterpret_cast<char*>(rawBuffer.data()), static_cast<std::streamsize>(bytes));
+	available = static_cast<size_t>(file.gcount());
+	position += available;
+	return rawBuffer.data();
+}
+
+void WavReader::skip(const size_t bytes) {
+	if (file.is_open()) {
+		file.seekg(static_cast<std::streamoff>(bytes), std::ios::cur);
+	}
+	position = std::min(position + bytes, file.is_open() ? SIZE_MAX : memory.size());
+}
+
+void WavReader::parseHeader(const std::string& path) {
+	size_t available = 0;
+	const uint8_t* riff = fetch(12, available);
+	if (available < 12) {
+		throw std::runtime_error(path + ": file too short");
+	}
+	if (std::memcmp(riff, "fLaC", 4) == 0) {
+		throw std::runtime_error(path + ": FLAC input is not supported by this build, convert to WAV");
+	}
+	if (std::memcmp(riff, "RIFF", 4) != 0 || std::memcmp(riff + 8, "WAVE", 4) != 0) {
+		throw std::runtime_error(path + ": not a RIFF/WAVE file");
+	}
+
+	bool haveFormat = false;
+	uint16_t formatTag = 0;
+	uint16_t bitsPerSample = 0;
+
+	uint32_t dataSize = 0;
+	bool haveData = false;
+	while (!haveData) {
+		const uint8_t* chunkHeader = fetch(8, available);
+		if (available < 8) {
+			break;
+		}
+		const uint32_t chunkSize = readU32(chunkHeader + 4);
+
+		if (std::memcmp(chunkHeader, "fmt ", 4) == 0) {
+			if (chunkSize < 16) {
+				throw std::runtime_error(path + ": malformed fmt chunk");
+			}
+			const uint8_t* fmt = fetch(chunkSize, available);
+			if (available < chunkSize) {
+				throw std::runtime_error(path + ": truncated fmt chunk");
+			}
+
+			formatTag = readU16(fmt);
+			channelCount = readU16(fmt + 2);
+			sampleRate = readU32(fmt + 4);
+			bitsPerSample = readU16(fmt + 14);
+			if (formatTag == WAVE_FORMAT_EXTENSIBLE && chunkSize >= 26) {
+				// The first two bytes of the SubFormat GUID carry the real format tag
+				formatTag = readU16(fmt + 24);
+			}
+			haveFormat = true;
+			skip(chunkSize & 1);
+		} else if (std::memcmp(chunkHeader, "data", 4) == 0) {
+			if (!haveFormat) {
+				throw std::runtime_error(path + ": data chunk before fmt chunk");
+			}
+			dataSize = chunkSize;
+			haveData = true;
+		} else {
+			skip(chunkSize + (chunkSize & 1));
+		}
+	}
+
+	if (!haveData) {
+		throw std::runtime_error(path + ": no audio data");
+	}
+
+	bytesPerSample = bitsPerSample / 8u;
+
+	if (formatTag == WAVE_FORMAT_IEEE_FLOAT && (bitsPerSample == 32 || bitsPerSample == 64)) {
+		format = SampleFormat::Float;
+	} else if (formatTag == WAVE_FORMAT_PCM && bitsPerSample % 8 == 0 && bitsPerSample >= 8 &&
+			   bitsPerSample <= 32) {
+		format = SampleFormat::Pcm;
+	} else {
+		throw std::runtime_error(path + ": unsupported sample format (tag " +
+								 std::to_string(formatTag) + ", " +
+								 std::to_string(bitsPerSample) + " bits)");
+	}
+
+	if (channelCount < 1 || sampleRate == 0) {
+		throw std::runtime_error(path + ": invalid channel count or sample rate");
+	}
+
+	const uint64_t bytesPerFrame = static_cast<uint64_t>(bytesPerSample) * static_cast<uint64_t>(channelCount);
+	// Streaming writers leave the size at 0 or 0xFFFFFFFF; read until EOF in that case
+	frameCount = dataSize == 0 || dataSize == 0xFFFFFFFF ? UINT64_MAX : dataSize / bytesPerFrame;
+	framesRemaining = frameCount;
+}
+
+size_t WavReader::read(float* output, const size_t maxFrames) {
+	const auto channels = static_cast<size_t>(channelCount);
+	const size_t bytesPerFrame = bytesPerSample * channels;
+	const size_t framesWanted = static_cast<size_t>(std::min<uint64_t>(maxFrames, framesRemaining));
+	if (framesWanted == 0) {
+		return 0;
+	}
+
+	size_t available = 0;
+	const uint8_t* raw = fetch(framesWanted * bytesPerFrame, available);
+	const size_t framesRead = available / bytesPerFrame;
+	framesRemaining = framesRead < framesWanted ? 0 : framesRemaining - framesRead;
+
+	const bool isFloat = format == SampleFormat::Float;
+	for (size_t i = 0; i < framesRead * channels; ++i) {
+		output[i] = decodeSample(raw + i * bytesPerSample, bytesPerSample, isFloat);
+	}
+
+	return framesRead;
+}
+
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace Offline {
+
+// Streaming RIFF/WAVE decoder. Handles 8/16/24/32-bit PCM and 32/64-bit IEEE float,
+// including WAVE_FORMAT_EXTENSIBLE headers. Reads either from a file or from a block of
+// memory (e.g. a MappedFile), in which case samples are decoded straight from it.
+// Throws std::runtime_error on anything it cannot decode.
+class WavReader {
+public:
+	explicit WavReader(const std::string& path);
+	WavReader(std::span<const uint8_t> bytes, const std::string& name);
+
+	int getChannelCount() const { return channelCount; }
+	float getSampleRate() const { return static_cast<float>(sampleRate); }
+	uint64_t getFrameCount() const { return frameCount; }  // UINT64_MAX if the header does not say
+
+	// Reads up to maxFrames interleaved frames, converted to float in [-1, 1].
+	// Returns the number of frames read; 0 at end of data.
+	size_t read(float* output, size_t maxFrames);
+
+	// Byte offset of the next unread sample, for callers managing the memory behind it
+	size_t getPosition() const { return position; }
+
+private:
+	enum class SampleFormat { Pcm, Float };
+
+	std::ifstream file;
+	std::span<const uint8_t> memory;
+	size_t position = 0;
+
+	SampleFormat format = SampleFormat::Pcm;
+	int channelCount = 0;
+	uint32_t sampleRate = 0;
+	uint32_t bytesPerSample = 0;
+	uint64_t frameCount = 0;
+	uint64_t framesRemaining = 0;
+	std::vector<uint8_t> rawBuffer;
+
+	void parseHeader(const std::string& name);
+	const uint8_t* fetch(size_t bytes, size_t& available);
+	void skip(size_t bytes);
+};
+
+}
@@ -9,7 +9,6 @@
 
 #include "audio_input.h"
 #include "controls.h"
-#include "colour_mapper.h"
 #include "fft_processor.h"
 #include "smoothing.h"
 #include "styling.h"
@@ -58,65 +57,75 @@ void updateUI(AudioInput& audioInput, const std::vector<AudioInput::DeviceInfo>&
         state.updateChecker.drawUpdateBanner(state.updateState, io.DisplaySize.x, SIDEBAR_WIDTH);
     }
     
+	// One snapshot for the whole UI frame so peaks, colour and spectrum agree
+	const auto frame = audioInput.getLatestFrame();
+
 	if (state.deviceState.selectedDeviceIndex >= 0) {
-		float whiteMix = 0.0f;
-		float gamma = 0.8f;
-		
 		audioInput.getFFTProcessor().setEQGains(state.lowGain, state.midGain, state.highGain);
-		
-		auto peaks = audioInput.getFrequencyPeaks();
-		std::vector<float> freqs, mags;
-		freqs.reserve(peaks.size());
-		mags.reserve(peaks.size());
-		for (const auto& peak : peaks) {
-			freqs.push_back(peak.frequency);
-			mags.push_back(peak.magnitude);
-		}
-
-		auto colourResult = ColourMapper::frequenciesToColour(freqs, mags, {}, UIConstants::DEFAULT_SAMPLE_RATE, gamma, state.useP3ColourSpace);
 
-		colourResult.r = colourResult.r * (1.0f - whiteMix) + whiteMix;
-		colourResult.g = colourResult.g * (1.0f - whiteMix) + whiteMix;
-		colourResult.b = colourResult.b * (1.0f - whiteMix) + whiteMix;
+		// The worker maps every frame to a colour; the UI only chooses how
+		const AudioProcessor::ColourSettings colourSettings{UIConstants::DEFAULT_GAMMA,
+															state.useP3ColourSpace, true};
+		if (audioInput.getColourSettings() != colourSettings) {
+			audioInput.setColourSettings(colourSettings);
+		}
 
-		colourResult.r = std::clamp(colourResult.r, 0.0f, 1.0f);
-		colourResult.g = std::clamp(colourResult.g, 0.0f, 1.0f);
-		colourResult.b = std::clamp(colourResult.b, 0.0f, 1.0f);
+		const bool newFrame = frame->sequence != state.lastFrameSequence;
+		state.lastFrameSequence = frame->sequence;
 
 		bool currentValid = std::isfinite(clear_color[0]) && std::isfinite(clear_color[1]) &&
 							std::isfinite(clear_color[2]);
 
-		bool newValid = std::isfinite(colourResult.r) && std::isfinite(colourResult.g) &&
-						std::isfinite(colourResult.b);
-
 		if (!currentValid) {
 			clear_color[0] = clear_color[1] = clear_color[2] = 0.1f;
 		}
 
+		const auto& colour = frame->colour;
+		bool newValid = std::isfinite(colour.r) && std::isfinite(colour.g) &&
+						std::isfinite(colour.b);
+
 		if (newValid) {
+			const float r = std::clamp(colour.r, 0.0f, 1.0f);
+			const float g = std::clamp(colour.g, 0.0f, 1.0f);
+			const float b = std::clamp(colour.b, 0.0f, 1.0f);
+
 			if (state.smoothingEnabled) {
-				colourSmoother.setTargetColour(colourResult.r, colourResult.g, colourResult.b);
+				if (newFrame) {
+					colourSmoother.setTargetColour(r, g, b);
+				}
 				colourSmoother.update(deltaTime * UIConstants::COLOUR_SMOOTH_UPDATE_FACTOR);
 				colourSmoother.getCurrentColour(clear_color[0], clear_color[1], clear_color[2]);
 			} else {
-				clear_color[0] = colourResult.r;
-				clear_color[1] = colourResult.g;
-				clear_color[2] = colourResult.b;
+				clear_color[0] = r;
+				clear_color[1] = g;
+				clear_color[2] = b;
 			}
 		}
 		
 #ifdef ENABLE_API_SERVER
-		auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
-		api.updateFinalColour(clear_color[0], clear_color[1], clear_color[2],
-		                     freqs, mags, static_cast<uint32_t>(UIConstants::DEFAULT_SAMPLE_RATE), 
-		                     1024);
+		if (newFrame) {
+			std::vector<float> freqs, mags;
+			freqs.reserve(frame->peaks.size());
+			mags.reserve(frame->peaks.size());
+			for (const auto& peak : frame->peaks) {
+				freqs.push_back(peak.frequency);
+				mags.push_back(peak.magnitude);
+			}
+
+			auto& api = Synesthesia::SynesthesiaAPIIntegration::getInstance();
+			api.updateFinalColour(clear_color[0], clear_color[1], clear_color[2],
+			                     freqs, mags, static_cast<uint32_t>(frame->sampleRate),
+			                     FFTProcessor::FFT_SIZE, frame->captureTime);
+			api.updateCaptureStats(audioInput.getCaptureStats());
+			api.updateSpectralFeatures(frame->features, frame->captureTime);
+		}
 #endif
 
-		const auto& magnitudes = audioInput.getFFTProcessor().getMagnitudesBuffer();
+		const auto& magnitudes = frame->magnitudes;
 		if (state.smoothedMagnitudes.size() != magnitudes.size()) {
 			state.smoothedMagnitudes.assign(magnitudes.size(), 0.0f);
 		}
-		const size_t count = magnitudes.size();
+		const size_t count = newFrame ? magnitudes.size() : 0;
 
 		for (size_t i = 0; i < count; ++i) {
 			state.smoothedMagnitudes[i] =
@@ -177,8 +186,9 @@ void updateUI(AudioInput& audioInput, const std::vector<AudioInput::DeviceInfo>&
 			constexpr float LABEL_WIDTH = 90.0f;
 			
 			DeviceManager::renderChannelSelection(state.deviceState, audioInput, devices);
+			DeviceManager::renderCaptureSettings(state.deviceState, audioInput, devices);
 
-			Controls::renderFrequencyInfoPanel(audioInput, clear_color, state);
+			Controls::renderFrequencyInfoPanel(*frame, clear_color);
 			
 			Controls::renderVisualiserSettingsPanel(
 				colourSmoother, 
@@ -224,8 +234,7 @@ void updateUI(AudioInput& audioInput, const std::vector<AudioInput::DeviceInfo>&
 		if (state.deviceState.selectedDeviceIndex >= 0 && !state.deviceState.streamError && state.showSpectrumAnalyser) {
 			SpectrumAnalyser::drawSpectrumWindow(
 				state.smoothedMagnitudes,
-				devices,
-				state.deviceState.selectedDeviceIndex,
+				frame->sampleRate,
 				displaySize,
 				SIDEBAR_WIDTH,
 				state.sidebarOnLeft
@@ -9,7 +9,6 @@
 #include <vector>
 
 namespace UIConstants {
-    static constexpr float DEFAULT_SAMPLE_RATE = 44100.0f;
     static constexpr float DEFAULT_SMOOTHING_SPEED = 0.6f;
     static constexpr float DEFAULT_GAMMA = 0.8f;
     static constexpr float COLOUR_SMOOTH_UPDATE_FACTOR = 1.2f;
@@ -29,6 +28,7 @@ struct UIState {
     bool showSpectrumAnalyser = true;
 
     std::vector<float> smoothedMagnitudes;
+    uint64_t lastFrameSequence = 0;  // last analysis frame folded into the smoothers
     float spectrumSmoothingFactor = 0.2f;
 
     StyleState styleState;
@@ -12,27 +12,14 @@
 
 namespace Controls {
 
-void renderFrequencyInfoPanel(AudioInput& audioInput, float* clear_color, const UIState& state) {
+void renderFrequencyInfoPanel(const AnalysisFrame& frame, const float* clear_color) {
     if (ImGui::CollapsingHeader("FREQUENCY INFO", ImGuiTreeNodeFlags_DefaultOpen)) {
         ImGui::Indent(10);
         
-        auto peaks = audioInput.getFrequencyPeaks();
-        
-        std::vector<float> frequencies, magnitudes;
-        frequencies.reserve(peaks.size());
-        magnitudes.reserve(peaks.size());
-        for (const auto& peak : peaks) {
-            frequencies.push_back(peak.frequency);
-            magnitudes.push_back(peak.magnitude);
-        }
-        
-        auto currentColourResult = ColourMapper::frequenciesToColour(
-            frequencies, magnitudes, {}, UIConstants::DEFAULT_SAMPLE_RATE, UIConstants::DEFAULT_GAMMA, state.useP3ColourSpace);
-
-        if (!peaks.empty()) {
-            ImGui::Text("Dominant: %.1f Hz", static_cast<double>(peaks[0].frequency));
-            ImGui::Text("Wavelength: %.1f nm", static_cast<double>(currentColourResult.dominantWavelength));
-            ImGui::Text("Number of peaks detected: %d", static_cast<int>(peaks.size()));
+        if (!frame.peaks.empty()) {
+            ImGui::Text("Dominant: %.1f Hz", static_cast<double>(frame.dominantFrequency));
+            ImGui::Text("Wavelength: %.1f nm", static_cast<double>(frame.colour.dominantWavelength));
+            ImGui::Text("Number of peaks detected: %d", static_cast<int>(frame.peaks.size()));
         } else {
             ImGui::TextDisabled("No significant frequencies");
         }
@@ -227,7 +214,9 @@ void renderAdvancedSettingsPanel(UIState& state) {
                 ImGui::Text("Mode: %s", high_perf ? "High Perf" : "Standard");
                 if (avg_frame_time > 0) {
                     ImGui::Text("Frame Time: %.2fms", static_cast<double>(avg_frame_time));
-                    float estimated_latency = avg_frame_time;
+                    // Audio-in to wire-out, measured from the ADC capture time of each frame
+                    auto capture_latency = api.getCaptureLatency();
+                    float estimated_latency = capture_latency.samples > 0 ? capture_latency.averageMs : avg_frame_time;
                     ImGui::Text("Latency: ~%.1fms", static_cast<double>(estimated_latency));
                     
                     if (estimated_latency < 5.0f) {
@@ -9,7 +9,7 @@
 struct UIState;
 
 namespace Controls {
-    void renderFrequencyInfoPanel(AudioInput& audioInput, float* clear_color, const UIState& state);
+    void renderFrequencyInfoPanel(const AnalysisFrame& frame, const float* clear_color);
     
     void renderVisualiserSettingsPanel(SpringSmoother& colourSmoother, 
                                      float& smoothingAmount,
@@ -3,6 +3,18 @@
 #include <algorithm>
 #include <string>
 
+namespace {
+
+constexpr const char* BUFFER_SIZE_NAMES[] = {"64", "128", "256", "512", "1024", "2048"};
+constexpr int BUFFER_SIZES[] = {64, 128, 256, 512, 1024, 2048};
+constexpr const char* SAMPLE_RATE_NAMES[] = {"Device default", "44100 Hz", "48000 Hz",
+                                             "96000 Hz", "192000 Hz"};
+constexpr double SAMPLE_RATES[] = {0.0, 44100.0, 48000.0, 96000.0, 192000.0};
+constexpr const char* HOP_SIZE_NAMES[] = {"128", "256", "512", "1024", "2048"};
+constexpr size_t HOP_SIZES[] = {128, 256, 512, 1024, 2048};
+
+}
+
 void DeviceManager::populateDeviceNames(DeviceState& deviceState, 
                                         const std::vector<AudioInput::DeviceInfo>& devices) {
     if (!deviceState.deviceNamesPopulated && !devices.empty()) {
@@ -85,6 +97,68 @@ void DeviceManager::renderChannelSelection(DeviceState& deviceState,
     }
 }
 
+void DeviceManager::renderCaptureSettings(DeviceState& deviceState,
+                                         AudioInput& audioInput,
+                                         const std::vector<AudioInput::DeviceInfo>& devices) {
+    bool reopen = false;
+
+    ImGui::Text("BUFFER SIZE");
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::Combo("##buffersize", &deviceState.bufferSizeIndex, BUFFER_SIZE_NAMES,
+                     IM_ARRAYSIZE(BUFFER_SIZE_NAMES))) {
+        reopen = true;
+    }
+
+    ImGui::Text("SAMPLE RATE");
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::Combo("##samplerate", &deviceState.sampleRateIndex, SAMPLE_RATE_NAMES,
+                     IM_ARRAYSIZE(SAMPLE_RATE_NAMES))) {
+        reopen = true;
+    }
+
+    ImGui::Text("ANALYSIS HOP");
+    ImGui::SetNextItemWidth(-FLT_MIN);
+    if (ImGui::Combo("##hopsize", &deviceState.hopSizeIndex, HOP_SIZE_NAMES,
+                     IM_ARRAYSIZE(HOP_SIZE_NAMES))) {
+        audioInput.setHopSize(HOP_SIZES[deviceState.hopSizeIndex]);
+    }
+    ImGui::Spacing();
+
+    if (!reopen) {
+        return;
+    }
+
+    const AudioInput::CaptureConfig previous = audioInput.getCaptureConfig();
+    AudioInput::CaptureConfig config = previous;
+    config.framesPerBuffer = BUFFER_SIZES[deviceState.bufferSizeIndex];
+    config.sampleRate = SAMPLE_RATES[deviceState.sampleRateIndex];
+    config.decimation = 0;  // high rates are analysed at 44.1-48 kHz
+    audioInput.setCaptureConfig(config);
+
+    // Reopening keeps the channel the user was listening to. A device that refuses the
+    // new settings goes back to the old ones rather than being left closed.
+    const int channel = deviceState.selectedChannelIndex;
+    const int device = deviceState.selectedDeviceIndex;
+    if (!selectDevice(deviceState, audioInput, devices, device)) {
+        audioInput.setCaptureConfig(previous);
+        for (int i = 0; i < IM_ARRAYSIZE(BUFFER_SIZES); ++i) {
+            if (BUFFER_SIZES[i] == previous.framesPerBuffer) {
+                deviceState.bufferSizeIndex = i;
+            }
+        }
+        for (int i = 0; i < IM_ARRAYSIZE(SAMPLE_RATES); ++i) {
+            if (SAMPLE_RATES[i] == previous.sampleRate) {
+                deviceState.sampleRateIndex = i;
+            }
+        }
+        if (!selectDevice(deviceState, audioInput, devices, device)) {
+            return;
+        }
+    }
+    selectChannel(deviceState, audioInput,
+                  channel < static_cast<int>(deviceState.channelNames.size()) ? channel : 0);
+}
+
 void DeviceManager::createChannelNames(DeviceState& deviceState, int channelsToUse) {
     deviceState.channelNameStrings.clear();
     deviceState.channelNameStrings.reserve(static_cast<size_t>(channelsToUse));
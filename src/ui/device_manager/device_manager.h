@@ -15,6 +15,11 @@ struct DeviceState {
     std::vector<const char*> channelNames;
     std::vector<std::string> channelNameStrings;
     bool deviceNamesPopulated = false;
+
+    // Indices into the capture option lists in device_manager.cpp
+    int bufferSizeIndex = 5;
+    int sampleRateIndex = 0;
+    int hopSizeIndex = 4;
 };
 
 struct DeviceSelectionResult {
@@ -44,6 +49,11 @@ public:
                                       AudioInput& audioInput,
                                       const std::vector<AudioInput::DeviceInfo>& devices);
 
+    // Buffer size and sample rate reopen the current device; the hop applies at once
+    static void renderCaptureSettings(DeviceState& deviceState,
+                                     AudioInput& audioInput,
+                                     const std::vector<AudioInput::DeviceInfo>& devices);
+
 private:
     static void createChannelNames(DeviceState& deviceState, int channelsToUse);
     static void resetDeviceState(DeviceState& deviceState);
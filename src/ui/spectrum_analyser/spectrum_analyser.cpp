@@ -1,6 +1,5 @@
 #include "spectrum_analyser.h"
 #include "fft_processor.h"
-#include <portaudio.h>
 #include <algorithm>
 #include <cmath>
 
@@ -14,8 +13,7 @@ bool SpectrumAnalyser::buffersInitialised = false;
 
 void SpectrumAnalyser::drawSpectrumWindow(
     const std::vector<float>& smoothedMagnitudes,
-    const std::vector<AudioInput::DeviceInfo>& devices,
-    int selectedDeviceIndex,
+    const float sampleRate,
     const ImVec2& displaySize,
     float sidebarWidth,
     bool sidebarOnLeft
@@ -36,8 +34,7 @@ void SpectrumAnalyser::drawSpectrumWindow(
 
     std::vector<float> xData(LINE_COUNT);
     std::vector<float> yData(LINE_COUNT);
-    float sampleRate = getSampleRate(devices, selectedDeviceIndex);
-    
+
     prepareSpectrumData(xData, yData, smoothedMagnitudes, sampleRate);
     applyTemporalSmoothing(yData);
     smoothData(yData);
@@ -86,16 +83,6 @@ void SpectrumAnalyser::drawSpectrumWindow(
     ImGui::PopStyleVar();
 }
 
-float SpectrumAnalyser::getSampleRate(const std::vector<AudioInput::DeviceInfo>& devices, int selectedDeviceIndex) {
-    float sampleRate = 44100.0f;
-    if (selectedDeviceIndex >= 0 && static_cast<size_t>(selectedDeviceIndex) < devices.size()) {
-        if (const PaDeviceInfo* deviceInfo = Pa_GetDeviceInfo(devices[static_cast<size_t>(selectedDeviceIndex)].paIndex)) {
-            sampleRate = static_cast<float>(deviceInfo->defaultSampleRate);
-        }
-    }
-    return sampleRate;
-}
-
 void SpectrumAnalyser::prepareSpectrumData(std::vector<float>& xData, std::vector<float>& yData,
                                            const std::vector<float>& magnitudes, float sampleRate) {
     if (!buffersInitialised) {
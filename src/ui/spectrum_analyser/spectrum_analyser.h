@@ -4,14 +4,12 @@
 #include <imgui.h>
 #include <implot.h>
 #include <vector>
-#include "audio_input.h"
 
 class SpectrumAnalyser {
 public:
     static void drawSpectrumWindow(
         const std::vector<float>& smoothedMagnitudes,
-        const std::vector<AudioInput::DeviceInfo>& devices,
-        int selectedDeviceIndex,
+        float sampleRate,
         const ImVec2& displaySize,
         float sidebarWidth,
         bool sidebarOnLeft = false
@@ -33,7 +31,6 @@ private:
     static float lastCachedSampleRate; // Track sample rate for cache validity
     static bool buffersInitialised;
     
-    static float getSampleRate(const std::vector<AudioInput::DeviceInfo>& devices, int selectedDeviceIndex);
     static void prepareSpectrumData(std::vector<float>& xData, std::vector<float>& yData, 
                                    const std::vector<float>& magnitudes, float sampleRate);
     static void smoothData(std::vector<float>& yData);
@@ -15,7 +15,9 @@ ZeroCrossingDetector::ZeroCrossingDetector()
 	  estimatedFrequency(0.0f),
 	  zeroCrossingDensity(0.0f),
 	  zeroCrossings(0),
-	  sampleCount(0) {}
+	  sampleCount(0) {
+	periods.reserve(BUFFER_SIZE / 2);
+}
 
 void ZeroCrossingDetector::processSamples(const float* buffer, const size_t numSamples) {
 	if (!buffer || numSamples == 0)
@@ -51,6 +53,16 @@ void ZeroCrossingDetector::processSamples(const float* buffer, const size_t numS
 	}
 }
 
+void ZeroCrossingDetector::setSampleRate(const float rate) {
+	if (rate <= 0.0f || rate == sampleRate) {
+		return;
+	}
+
+	reset();
+	std::lock_guard lock(bufferMutex);
+	sampleRate = rate;
+}
+
 void ZeroCrossingDetector::analyseZeroCrossings() {
 	if (sampleCount == 0)
 		return;
@@ -62,8 +74,7 @@ void ZeroCrossingDetector::analyseZeroCrossings() {
 
 	const float roughFreq = zeroCrossingDensity / 2.0f;
 
-	std::vector<float> periods;
-	periods.reserve(zeroCrossings);
+	periods.clear();
 
 	float prevCrossing = 0.0f;
 	bool foundFirst = false;
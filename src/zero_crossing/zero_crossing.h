@@ -8,6 +8,9 @@ public:
 	ZeroCrossingDetector();
 
 	void processSamples(const float* buffer, size_t numSamples);
+	// A change starts the estimate afresh, since the collected crossings were timed at the
+	// old rate
+	void setSampleRate(float rate);
 	float getEstimatedFrequency() const;
 	float getZeroCrossingDensity() const;
 	void reset();
@@ -18,6 +21,7 @@ private:
 	static constexpr float MAX_PERIOD = 0.05f;
 
 	std::vector<float> sampleBuffer;
+	std::vector<float> periods;	 // analysis scratch, reserved for every crossing BUFFER_SIZE can hold
 	mutable std::mutex bufferMutex;
 
 	float lastSample;